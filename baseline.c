@@ -0,0 +1,177 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include "baseline.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+
+#define BASELINE_MAGIC "SORT-BASELINE"
+#define BASELINE_FORMAT_VERSION 1 //must be incremented whenever the format of the file changes
+#define BASELINE_ID_LEN 64
+
+/*
+ * A cell of a baseline. In the file, each one is a line: "cell TYPE CASE ALGORITHM SIZE COUNT" followed by its COUNT samples.
+ */
+typedef struct {
+    char type_id[BASELINE_ID_LEN], case_id[BASELINE_ID_LEN], algorithm_id[BASELINE_ID_LEN];
+    size_t size;
+    Samples samples;
+} BaselineCell;
+
+struct Baseline {
+    BaselineCell *cells;
+    int count, capacity;
+};
+
+Baseline* baseline_new(void)
+{
+    Baseline *baseline = malloc(sizeof(Baseline));  assert(baseline != NULL);
+    *baseline = (Baseline) {NULL, 0, 0};
+    return baseline;
+}
+
+int baseline_size(const Baseline *baseline) {return baseline->count;}
+
+/*
+ * Adds a cell (with a copy of its samples) to the baseline. The ids must be shorter than BASELINE_ID_LEN and have no whitespace.
+ */
+void baseline_add(Baseline *baseline, const char *type_id, const char *case_id, const char *algorithm_id, size_t size, const Samples *samples)
+{
+    assert(strlen(type_id) < BASELINE_ID_LEN && strlen(case_id) < BASELINE_ID_LEN && strlen(algorithm_id) < BASELINE_ID_LEN);
+    if(baseline->count == baseline->capacity) {
+        baseline->capacity = (baseline->capacity == 0) ? 64 : 2*baseline->capacity;
+        baseline->cells = realloc(baseline->cells, baseline->capacity * sizeof(BaselineCell));  assert(baseline->cells != NULL);
+    }
+
+    BaselineCell *cell = &baseline->cells[baseline->count++];
+    strcpy(cell->type_id, type_id);  strcpy(cell->case_id, case_id);  strcpy(cell->algorithm_id, algorithm_id);
+    cell->size = size;
+    samples_init(&cell->samples);
+    samples_append(&cell->samples, samples);
+}
+
+/*
+ * Returns the samples of the given cell of the baseline or NULL if it isn't there.
+ */
+const Samples* baseline_find(const Baseline *baseline, const char *type_id, const char *case_id, const char *algorithm_id, size_t size)
+{
+    for(int i = 0; i < baseline->count; i++) {
+        const BaselineCell *cell = &baseline->cells[i];
+        if(cell->size == size && strcmp(cell->algorithm_id, algorithm_id) == 0 && strcmp(cell->case_id, case_id) == 0 && strcmp(cell->type_id, type_id) == 0)
+            return &cell->samples;
+    }
+    return NULL;
+}
+
+/*
+ * Saves the baseline to a text file. It's written under a temporary name and then renamed, so an interrupted run never destroys the previous baseline. Returns false if it couldn't be saved.
+ */
+bool baseline_save(const Baseline *baseline, const char *path)
+{
+    char temp_path[PATH_MAX + 32];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    FILE *file = fopen(temp_path, "w");
+    if(file == NULL)
+        return false;
+
+    fprintf(file, "%s %d\n", BASELINE_MAGIC, BASELINE_FORMAT_VERSION);
+    for(int i = 0; i < baseline->count; i++) {
+        const BaselineCell *cell = &baseline->cells[i];
+        fprintf(file, "cell %s %s %s %zu %d", cell->type_id, cell->case_id, cell->algorithm_id, cell->size, cell->samples.count);
+        for(int s = 0; s < cell->samples.count; s++)
+            fprintf(file, " %.9e", cell->samples.values[s]);
+        fprintf(file, "\n");
+    }
+
+    bool ok = !ferror(file);
+    ok = (fclose(file) == 0) && ok;
+    if(!ok || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Loads a baseline saved by baseline_save. Returns NULL (and prints the reason to stderr) if it doesn't exist or is invalid.
+ */
+Baseline* baseline_load(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if(file == NULL) {
+        fprintf(stderr, "Couldn't open the baseline \"%s\"!\n", path);
+        return NULL;
+    }
+
+    int version;
+    if(fscanf(file, " " BASELINE_MAGIC " %d", &version) != 1 || version != BASELINE_FORMAT_VERSION) {
+        fprintf(stderr, "\"%s\" isn't a baseline of this version of the program!\n", path);
+        fclose(file);
+        return NULL;
+    }
+
+    Baseline *baseline = baseline_new();
+    Samples samples;
+    samples_init(&samples);
+    char type_id[BASELINE_ID_LEN], case_id[BASELINE_ID_LEN], algorithm_id[BASELINE_ID_LEN];
+    size_t size;
+    int count;
+    bool ok = true;
+    while(ok && fscanf(file, " cell %63s %63s %63s %zu %d", type_id, case_id, algorithm_id, &size, &count) == 5) {
+        samples_clear(&samples);
+        for(int s = 0; ok && s < count; s++) {
+            double value;
+            ok = fscanf(file, " %lf", &value) == 1;
+            samples_add(&samples, value);
+        }
+        if(ok)
+            baseline_add(baseline, type_id, case_id, algorithm_id, size, &samples);
+    }
+    ok = ok && feof(file);
+    samples_free(&samples);
+    fclose(file);
+
+    if(!ok) {
+        fprintf(stderr, "The baseline \"%s\" is corrupted!\n", path);
+        baseline_free(baseline);
+        return NULL;
+    }
+    return baseline;
+}
+
+void baseline_free(Baseline *baseline)
+{
+    for(int i = 0; i < baseline->count; i++)
+        samples_free(&baseline->cells[i].samples);
+    free(baseline->cells);
+    free(baseline);
+}
+
+/*
+ * Compares the samples of a cell with the ones of its baseline (see BaselineComparison). The medians are compared, instead of the means, since they aren't dragged by the few runs slowed down by interruptions.
+ */
+BaselineComparison compare_to_baseline(const Samples *baseline, const Samples *current, double threshold, double significance)
+{
+    BaselineComparison comparison;
+    comparison.baseline_median = compute_statistics(baseline).median;
+    comparison.current_median = compute_statistics(current).median;
+    comparison.speedup = (comparison.current_median > 0) ? comparison.baseline_median / comparison.current_median : 1;
+    comparison.p_value = mann_whitney_p_value(baseline, current);
+
+    if(baseline->count < MIN_BASELINE_SAMPLES || current->count < MIN_BASELINE_SAMPLES)
+        comparison.verdict = BASELINE_TOO_FEW_SAMPLES;
+    else if(comparison.p_value >= significance)
+        comparison.verdict = BASELINE_UNCHANGED;
+    else if(comparison.speedup < 1 / (1 + threshold))
+        comparison.verdict = BASELINE_REGRESSED;
+    else if(comparison.speedup > 1 + threshold)
+        comparison.verdict = BASELINE_IMPROVED;
+    else
+        comparison.verdict = BASELINE_UNCHANGED;
+    return comparison;
+}
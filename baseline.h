@@ -0,0 +1,42 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef BASELINE_H
+    #define BASELINE_H
+    #include <stdbool.h>
+    #include <stddef.h>
+    #include "statistics.h"
+
+    /*
+     * Baseline of the regression mode: the time samples of every measured (element type, case, algorithm, size) cell of a run, saved to a text file and compared against the cells of later runs.
+     * The cells are identified by the ids of the element type, case and algorithm, so a baseline stays valid when algorithms are added, removed or reordered.
+     */
+    typedef struct Baseline Baseline;
+
+    Baseline* baseline_new(void);
+    void baseline_add(Baseline *baseline, const char *type_id, const char *case_id, const char *algorithm_id, size_t size, const Samples *samples);
+    const Samples* baseline_find(const Baseline *baseline, const char *type_id, const char *case_id, const char *algorithm_id, size_t size);
+    int baseline_size(const Baseline *baseline);
+    bool baseline_save(const Baseline *baseline, const char *path);
+    Baseline* baseline_load(const char *path);
+    void baseline_free(Baseline *baseline);
+
+    /*
+     * Result of comparing the samples of a cell with its baseline: "speedup" is the median time of the baseline divided by the current one (below 1 if it got slower) and "p_value" comes from the Mann-Whitney U test.
+     * A cell regressed if it got slower by more than the threshold (e.g. 0.05 = 5%) with a p-value below the significance level; the opposite is an improvement.
+     */
+    #define BASELINE_UNCHANGED 0
+    #define BASELINE_REGRESSED 1
+    #define BASELINE_IMPROVED 2
+    #define BASELINE_TOO_FEW_SAMPLES 3 //fewer than MIN_BASELINE_SAMPLES samples on any of the sides
+    #define MIN_BASELINE_SAMPLES 3
+
+    typedef struct {
+        double baseline_median, current_median, speedup, p_value;
+        int verdict;
+    } BaselineComparison;
+
+    BaselineComparison compare_to_baseline(const Samples *baseline, const Samples *current, double threshold, double significance);
+#endif
@@ -0,0 +1,812 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <math.h>
+#include <ctype.h>
+#include <errno.h>
+#include <assert.h>
+#include <sys/stat.h>
+#include "batch_mode.h"
+#include "sorting_algorithms.h"
+#include "results_writer.h"
+#include "external_sort.h"
+#include "sorting_networks.h"
+#include "dataset_cache.h"
+#include "buffers.h"
+#include "plugins.h"
+#include "complexity.h"
+#include "baseline.h"
+
+#define MAX_BATCH_SIZES 64 //maximum number of array sizes in a single run
+#define MAX_OPTION_LEN 1024 //maximum length of a line of a config file
+#define MAX_BASELINE_NAME 64
+
+/*
+ * Settings of a batch run.
+ */
+typedef struct {
+    bool algorithms[MAX_ALGORITHMS], cases[NUM_CASES], types[NUM_ELEMENT_TYPES];
+    size_t sizes[MAX_BATCH_SIZES];
+    int num_sizes;
+    int num_executions, num_workers, num_threads, almost_sorted_k, network_leaf_size, network_isa, partition, gap_sequence, shellsort_threads, generator_threads, huge_pages;
+    bool pin_workers, use_statistics, seed_set;
+    HeapVariant heap;
+    unsigned int seed;
+    StatisticsConfig config;
+    char output_dir[PATH_MAX], dataset_cache_dir[PATH_MAX]; //dataset_cache_dir is empty if the cache is disabled
+    bool algorithms_set; //true if the algorithms were chosen explicitly
+    char external_input[PATH_MAX], external_output[PATH_MAX], temp_dir[PATH_MAX]; //external sort mode (enabled if external_input isn't empty)
+    size_t generate_input, memory_mb, random_swaps;
+    int fan_in;
+    TimeBudget budget;
+    char save_baseline[MAX_BASELINE_NAME], compare_baseline[MAX_BASELINE_NAME], baseline_dir[PATH_MAX]; //regression mode (the names are empty if unused)
+    double regression_threshold, significance;
+} BatchOptions;
+
+/*
+ * Prints the usage of the batch mode.
+ */
+static void print_usage(FILE *file, const char *program)
+{
+    fprintf(file, "Usage: %s [options]\n"
+        "Runs the benchmarks without the interactive menu (run without arguments for the menu).\n\n"
+        "  --algorithms LIST     comma separated algorithm ids or \"all\" (default: all)\n"
+        "  --plugin FILE         load the algorithms of a sort plugin (a shared object, see sort_plugin.h); can be\n"
+        "                        repeated, and must come before the --algorithms that select its algorithms\n"
+        "  --cases LIST          comma separated array cases or \"all\" (default: all)\n"
+        "                        cases: random, almost_sorted, inversely_sorted, sorted,\n"
+        "                               few_unique (only %d distinct values), zipf (exponent 1), organ_pipe,\n"
+        "                               sawtooth (%d ascending runs), gaussian (mean n/2, std. deviation n/8),\n"
+        "                               random_swaps (sorted, then k pairs swapped at random)\n"
+        "  --types LIST          comma separated element types or \"all\" (default: int); the types other than int\n"
+        "                        only run the first %d algorithms (the others are skipped)\n"
+        "                        types: int, int64, float, double, kv (16-byte key/value records),\n"
+        "                               int64_callback (int64 compared through a function pointer)\n"
+        "  --sizes LIST          comma separated array sizes, e.g. 100,1e4,1e6 (default: 1e2,1e3,1e4,1e5,1e6)\n"
+        "  --executions N        number of arrays per case and size (default: 1)\n"
+        "  --warmups N           warmup runs per array (enables the statistics mode)\n"
+        "  --min-runs N          minimum measured runs per array, at least 2 (enables the statistics mode)\n"
+        "  --max-runs N          maximum measured runs per array, 0 = no limit (enables the statistics mode)\n"
+        "  --target-error P      target relative error of the mean time, in %% (enables the statistics mode)\n"
+        "  --seed N              seed of the array generators (default: current time)\n"
+        "  --threads N           threads used by the parallel quicksort, 0 = all cores (default: 0)\n"
+        "  --workers N           worker threads running the jobs, 0 = all cores (default: 1); the jobs of the\n"
+        "                        multithreaded algorithms run alone, after the others\n"
+        "  --pin                 pin each worker to a different core\n"
+        "  --partition METHOD    partitioning of quicksort, parallel_quicksort and quicksort_network: hoare, block\n"
+        "                        (BlockQuicksort, branch-free) or lomuto (branchless Lomuto) (default: hoare)\n"
+        "  --gaps SEQUENCE       gap sequence of shellsort: ciura, tokuda, sedgewick or pratt (default: ciura)\n"
+        "  --shellsort-threads N threads sharing the h-sorts of shellsort's large gaps, 0 = all cores (default: 1)\n"
+        "  --heap-arity N        arity of the heap of heapsort: 2, 4 or 8 (default: 2)\n"
+        "  --heap-bottom-up      sift the elements of heapsort's heap bottom-up (Floyd's method)\n"
+        "  --heap-prefetch       prefetch the grandchildren of the heap nodes visited by heapsort\n"
+        "  --network-leaf N      sub-arrays up to N elements (2 - %d) are sorted by a sorting network in\n"
+        "                        quicksort_network and merge_sort_network (default: 32)\n"
+        "  --network-isa ISA     instruction set of the sorting networks: auto, avx2, sse4 or scalar (default: auto)\n"
+        "  --almost-sorted-k N   max. distance of an element from its sorted position in the almost sorted arrays (default: 10)\n"
+        "  --random-swaps K      pairs of elements swapped in the random_swaps arrays (default: 1%% of the size)\n"
+        "  --generator-threads N threads that generate the arrays, 0 = all cores (default: 0); the arrays don't depend on it\n"
+        "  --output DIR          directory where the results are saved (default: ./results)\n"
+        "  --huge-pages MODE     pages of the input and work buffers: off, thp (transparent huge pages) or hugetlb\n"
+        "                        (reserved huge pages, falling back to thp) (default: off)\n"
+        "  --dataset-cache DIR   save the generated arrays to DIR and load them from there on later runs with the same\n"
+        "                        seed, instead of generating them again (default: disabled)\n"
+        "  --cell-budget S       max. seconds of each (algorithm, size) cell; the sizes run in ascending order and an\n"
+        "                        algorithm skips the sizes whose time, predicted from the smaller ones, exceeds it (and\n"
+        "                        the measured runs of the statistics mode stop when it's reached) (default: no limit)\n"
+        "  --total-budget S      max. seconds of the whole run: the cells predicted to exceed what's left are skipped,\n"
+        "                        as is everything after it runs out (default: no limit)\n"
+        "  --timeout S           kill any single sort running longer than S seconds (the sorts run in a child process);\n"
+        "                        the cell is reported as timed out and the larger sizes of the algorithm are skipped\n"
+        "\nRegression mode (the baselines hold the time samples of every cell, so use --executions 3 or more or the\n"
+        "statistics mode):\n"
+        "  --save-baseline NAME  save the samples of this run as the baseline NAME (letters, digits, '_', '-' and '.')\n"
+        "  --compare-baseline NAME  compare the cells of this run with the baseline NAME (Mann-Whitney U test of the\n"
+        "                        samples); the report is saved to regressions.txt in the output directory\n"
+        "  --regression-threshold P  slowdown of the median time, in %%, that counts as a regression (default: 5)\n"
+        "  --significance A      max. p-value of a significant change (default: 0.05)\n"
+        "  --baseline-dir DIR    directory of the baselines (default: ./baselines)\n\n"
+        "  --config FILE         read options from FILE, one \"option = value\" per line (without the leading \"--\")\n"
+        "\nExternal sort mode (sorts a binary file of native ints that may be larger than the memory):\n"
+        "  --external FILE       sort FILE once with each of the selected algorithms generating the runs\n"
+        "                        (default algorithms: quicksort, merge_sort_bottom_up, lsd_radix_sort)\n"
+        "  --external-output F   where the sorted file is written (default: FILE.sorted)\n"
+        "  --generate-input N    first write N random ints to FILE\n"
+        "  --memory-mb N         memory budget of the runs and of the merges, in MiB (default: 256)\n"
+        "  --fan-in N            runs merged at a time (default: 64)\n"
+        "  --temp-dir DIR        directory of the temporary run files (default: the output directory)\n"
+        "  --help                show this message\n\n"
+        "Algorithm ids:", program, FEW_UNIQUE_VALUES, SAWTOOTH_TEETH, NUM_TYPED_ALGORITHMS, SORTING_NETWORK_MAX);
+    for(int i = 0; i < get_num_algorithms(); i++)
+        fprintf(file, " %s", get_algorithm_id(i));
+    fprintf(file, "\n\nExit codes: %d = ok, %d = an algorithm failed to sort, %d = invalid arguments, %d = I/O error, %d = out of memory,\n"
+            "%d = a regression was found (see --compare-baseline).\n", BATCH_OK, BATCH_SORT_FAILED, BATCH_BAD_ARGUMENTS, BATCH_IO_ERROR, BATCH_OUT_OF_MEMORY, BATCH_REGRESSION);
+}
+
+/*
+ * Parses a non-negative int. Accepts the scientific notation (e.g. 1e6) as long as the value is an integer.
+ */
+static bool parse_int(const char *str, int *value)
+{
+    char *end;
+    errno = 0;
+    double d = strtod(str, &end);
+    if(end == str || *end != '\0' || errno != 0 || d < 0 || d > INT_MAX || d != (int) d)
+        return false;
+    *value = (int) d;
+    return true;
+}
+
+/*
+ * Parses a non-negative number (e.g. of seconds).
+ */
+static bool parse_double(const char *str, double *value)
+{
+    char *end;
+    errno = 0;
+    double d = strtod(str, &end);
+    if(end == str || *end != '\0' || errno != 0 || !(d >= 0) || isinf(d))
+        return false;
+    *value = d;
+    return true;
+}
+
+/*
+ * Parses the name of a baseline, which becomes part of a path: 1 to MAX_BASELINE_NAME - 1 letters, digits, '_', '-' and '.' (but not only dots).
+ */
+static bool parse_baseline_name(const char *str, char *name)
+{
+    size_t len = strlen(str);
+    if(len == 0 || len >= MAX_BASELINE_NAME || strspn(str, ".") == len)
+        return false;
+    for(size_t i = 0; i < len; i++) {
+        if(!isalnum((unsigned char) str[i]) && strchr("_-.", str[i]) == NULL)
+            return false;
+    }
+    strcpy(name, str);
+    return true;
+}
+
+/*
+ * Parses an array size (at least 1). Like parse_int, accepts the scientific notation, but allows values beyond INT_MAX (up to 2^53, where the doubles stop being exact).
+ */
+static bool parse_size(const char *str, size_t *value)
+{
+    char *end;
+    errno = 0;
+    double d = strtod(str, &end);
+    if(end == str || *end != '\0' || errno != 0 || d < 1 || d > (double) (1ULL << 53) || d != (double) (uint64_t) d)
+        return false;
+    *value = (size_t) d;
+    return true;
+}
+
+/*
+ * Parses a comma separated list of names. "flags[i]" is set if the i-th name of "names" is on the list. "all" selects every name.
+ */
+static bool parse_name_list(const char *str, const char* (*get_name)(int index), int num_names, bool *flags)
+{
+    char buffer[MAX_OPTION_LEN];
+    if(strlen(str) >= sizeof(buffer))
+        return false;
+    strcpy(buffer, str);
+
+    memset(flags, 0, num_names * sizeof(bool));
+    for(char *token = strtok(buffer, ","); token != NULL; token = strtok(NULL, ",")) {
+        if(strcmp(token, "all") == 0) {
+            for(int i = 0; i < num_names; i++)
+                flags[i] = true;
+            continue;
+        }
+
+        int i = 0;
+        while(i < num_names && strcmp(get_name(i), token) != 0)
+            i++;
+        if(i == num_names) {
+            fprintf(stderr, "Unknown name: \"%s\"\n", token);
+            return false;
+        }
+        flags[i] = true;
+    }
+    return true;
+}
+
+/*
+ * Parses a comma separated list of array sizes.
+ */
+static bool parse_sizes(const char *str, BatchOptions *opts)
+{
+    char buffer[MAX_OPTION_LEN];
+    if(strlen(str) >= sizeof(buffer))
+        return false;
+    strcpy(buffer, str);
+
+    opts->num_sizes = 0;
+    for(char *token = strtok(buffer, ","); token != NULL; token = strtok(NULL, ",")) {
+        if(opts->num_sizes == MAX_BATCH_SIZES || !parse_size(token, &opts->sizes[opts->num_sizes]))
+            return false;
+        opts->num_sizes++;
+    }
+    return opts->num_sizes > 0;
+}
+
+/*
+ * Applies an option ("key" without the leading "--"). "value" is NULL for flags.
+ * Returns 1 if the option takes a value and 0 if it's a flag, or -1 if the option or its value is invalid.
+ */
+static int set_option(BatchOptions *opts, const char *key, const char *value);
+
+/*
+ * Reads the options of a config file. Each line has the form "option = value" (or just "option" for flags). Empty lines and lines starting with '#' are ignored.
+ */
+static int read_config_file(BatchOptions *opts, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if(file == NULL) {
+        fprintf(stderr, "Couldn't open the config file \"%s\"!\n", path);
+        return BATCH_IO_ERROR;
+    }
+
+    char line[MAX_OPTION_LEN];
+    int line_num = 0, status = BATCH_OK;
+    while(status == BATCH_OK && fgets(line, sizeof(line), file) != NULL) {
+        line_num++;
+
+        //splitting the line into key and value, trimming the whitespace
+        char *key = line + strspn(line, " \t");
+        key[strcspn(key, "\r\n")] = '\0';
+        if(*key == '\0' || *key == '#')
+            continue;
+
+        char *value = strchr(key, '=');
+        if(value != NULL) {
+            *value++ = '\0';
+            value += strspn(value, " \t");
+            for(char *end = value + strlen(value); end > value && (end[-1] == ' ' || end[-1] == '\t'); *--end = '\0');
+        }
+        for(char *end = key + strlen(key); end > key && (end[-1] == ' ' || end[-1] == '\t'); *--end = '\0');
+
+        int taken = set_option(opts, key, value);
+        if(taken < 0 || (taken == 0 && value != NULL) || (taken == 1 && value == NULL)) {
+            fprintf(stderr, "%s:%d: invalid option \"%s\"\n", path, line_num, key);
+            status = BATCH_BAD_ARGUMENTS;
+        }
+    }
+
+    fclose(file);
+    return status;
+}
+
+static int set_option(BatchOptions *opts, const char *key, const char *value)
+{
+    if(strcmp(key, "pin") == 0) {
+        opts->pin_workers = true;
+        return 0;
+    }
+    if(strcmp(key, "heap-bottom-up") == 0) {
+        opts->heap.bottom_up = true;
+        return 0;
+    }
+    if(strcmp(key, "heap-prefetch") == 0) {
+        opts->heap.prefetch = true;
+        return 0;
+    }
+    if(value == NULL)
+        return -1;
+
+    bool ok;
+    if(strcmp(key, "algorithms") == 0)
+        ok = opts->algorithms_set = parse_name_list(value, &get_algorithm_id, get_num_algorithms(), opts->algorithms);
+    else if(strcmp(key, "plugin") == 0) {
+        int first = get_num_algorithms();
+        ok = load_sort_plugin(value) >= 0;
+        for(int i = first; i < get_num_algorithms(); i++)
+            opts->algorithms[i] = !opts->algorithms_set;
+    }
+    else if(strcmp(key, "cases") == 0)
+        ok = parse_name_list(value, &get_case_id, NUM_CASES, opts->cases);
+    else if(strcmp(key, "types") == 0)
+        ok = parse_name_list(value, &get_element_type_id, NUM_ELEMENT_TYPES, opts->types);
+    else if(strcmp(key, "sizes") == 0)
+        ok = parse_sizes(value, opts);
+    else if(strcmp(key, "executions") == 0)
+        ok = parse_int(value, &opts->num_executions) && opts->num_executions >= 1;
+    else if(strcmp(key, "warmups") == 0)
+        ok = opts->use_statistics = parse_int(value, &opts->config.warmup_runs);
+    else if(strcmp(key, "min-runs") == 0)
+        ok = opts->use_statistics = parse_int(value, &opts->config.min_runs) && opts->config.min_runs >= 2;
+    else if(strcmp(key, "max-runs") == 0)
+        ok = opts->use_statistics = parse_int(value, &opts->config.max_runs);
+    else if(strcmp(key, "target-error") == 0) {
+        char *end;
+        opts->config.target_relative_error = strtod(value, &end) / 100;
+        ok = opts->use_statistics = (end != value && *end == '\0' && opts->config.target_relative_error > 0);
+    }
+    else if(strcmp(key, "seed") == 0) {
+        int seed;
+        ok = opts->seed_set = parse_int(value, &seed);
+        opts->seed = seed;
+    }
+    else if(strcmp(key, "threads") == 0)
+        ok = parse_int(value, &opts->num_threads);
+    else if(strcmp(key, "workers") == 0)
+        ok = parse_int(value, &opts->num_workers);
+    else if(strcmp(key, "gaps") == 0)
+        ok = (opts->gap_sequence = find_gap_sequence(value)) >= 0;
+    else if(strcmp(key, "shellsort-threads") == 0)
+        ok = parse_int(value, &opts->shellsort_threads);
+    else if(strcmp(key, "heap-arity") == 0)
+        ok = parse_int(value, &opts->heap.arity) && (opts->heap.arity == 2 || opts->heap.arity == 4 || opts->heap.arity == 8);
+    else if(strcmp(key, "partition") == 0)
+        ok = (opts->partition = find_partition(value)) >= 0;
+    else if(strcmp(key, "network-leaf") == 0)
+        ok = parse_int(value, &opts->network_leaf_size) && opts->network_leaf_size >= 2 && opts->network_leaf_size <= SORTING_NETWORK_MAX;
+    else if(strcmp(key, "network-isa") == 0)
+        ok = (opts->network_isa = find_network_isa(value)) >= 0;
+    else if(strcmp(key, "almost-sorted-k") == 0)
+        ok = parse_int(value, &opts->almost_sorted_k);
+    else if(strcmp(key, "random-swaps") == 0)
+        ok = parse_size(value, &opts->random_swaps) && opts->random_swaps > 0;
+    else if(strcmp(key, "generator-threads") == 0)
+        ok = parse_int(value, &opts->generator_threads);
+    else if(strcmp(key, "output") == 0)
+        ok = (strlen(value) > 0 && strlen(value) < sizeof(opts->output_dir) && strcpy(opts->output_dir, value) != NULL);
+    else if(strcmp(key, "cell-budget") == 0)
+        ok = parse_double(value, &opts->budget.cell_seconds);
+    else if(strcmp(key, "total-budget") == 0)
+        ok = parse_double(value, &opts->budget.total_seconds);
+    else if(strcmp(key, "timeout") == 0)
+        ok = parse_double(value, &opts->budget.timeout_seconds);
+    else if(strcmp(key, "save-baseline") == 0)
+        ok = parse_baseline_name(value, opts->save_baseline);
+    else if(strcmp(key, "compare-baseline") == 0)
+        ok = parse_baseline_name(value, opts->compare_baseline);
+    else if(strcmp(key, "regression-threshold") == 0) {
+        ok = parse_double(value, &opts->regression_threshold);
+        opts->regression_threshold /= 100;
+    }
+    else if(strcmp(key, "significance") == 0)
+        ok = parse_double(value, &opts->significance) && opts->significance > 0 && opts->significance < 1;
+    else if(strcmp(key, "baseline-dir") == 0)
+        ok = (strlen(value) > 0 && strlen(value) < sizeof(opts->baseline_dir) && strcpy(opts->baseline_dir, value) != NULL);
+    else if(strcmp(key, "huge-pages") == 0)
+        ok = (opts->huge_pages = find_huge_pages(value)) >= 0;
+    else if(strcmp(key, "dataset-cache") == 0)
+        ok = (strlen(value) > 0 && strlen(value) < sizeof(opts->dataset_cache_dir) && strcpy(opts->dataset_cache_dir, value) != NULL);
+    else if(strcmp(key, "external") == 0)
+        ok = (strlen(value) > 0 && strlen(value) < sizeof(opts->external_input) && strcpy(opts->external_input, value) != NULL);
+    else if(strcmp(key, "external-output") == 0)
+        ok = (strlen(value) > 0 && strlen(value) < sizeof(opts->external_output) && strcpy(opts->external_output, value) != NULL);
+    else if(strcmp(key, "temp-dir") == 0)
+        ok = (strlen(value) > 0 && strlen(value) < sizeof(opts->temp_dir) && strcpy(opts->temp_dir, value) != NULL);
+    else if(strcmp(key, "generate-input") == 0)
+        ok = parse_size(value, &opts->generate_input);
+    else if(strcmp(key, "memory-mb") == 0)
+        ok = parse_size(value, &opts->memory_mb);
+    else if(strcmp(key, "fan-in") == 0)
+        ok = parse_int(value, &opts->fan_in) && opts->fan_in >= 2;
+    else if(strcmp(key, "config") == 0)
+        ok = (read_config_file(opts, value) == BATCH_OK);
+    else
+        return -1;
+
+    return ok ? 1 : -1;
+}
+
+/*
+ * Saves the results of an algorithm on all the cases that were run with the given element type. The results of the types other than int go to "<algorithm>_<type>.txt".
+ */
+static int save_results(const BatchOptions *opts, int type, int alg, CaseResults *results[NUM_CASES])
+{
+    char path[PATH_MAX + 128];
+    if(type == INT_ELEMENTS)
+        snprintf(path, sizeof(path), "%s/%s.txt", opts->output_dir, get_algorithm_id(alg));
+    else
+        snprintf(path, sizeof(path), "%s/%s_%s.txt", opts->output_dir, get_algorithm_id(alg), get_element_type_id(type));
+    FILE *f = fopen(path, "w");
+    if(f == NULL) {
+        fprintf(stderr, "Couldn't open \"%s\" for writing!\n", path);
+        return BATCH_IO_ERROR;
+    }
+
+    time_now_to_file(f);
+    fprintf(f, "Algorithm: %s\n", get_algorithm_name(alg));
+    fprintf(f, "Properties: ");
+    fprint_algorithm_properties(f, alg);
+    fprintf(f, "%s\n", is_plugin_algorithm(alg) ? " (plugin)" : "");
+    fprintf(f, "Element type: %s\n", get_element_type_name(type));
+    if(strcmp(get_algorithm_id(alg), "shellsort") == 0)
+        fprintf(f, "Gap sequence: %s  |  threads: %d (0 = all the cores)\n", get_gap_sequence_id(opts->gap_sequence), opts->shellsort_threads);
+    if(strcmp(get_algorithm_id(alg), "heapsort") == 0)
+        fprintf(f, "Heap: %d-ary  |  sift: %s  |  prefetching: %s\n", opts->heap.arity, opts->heap.bottom_up ? "bottom-up" : "top-down", opts->heap.prefetch ? "yes" : "no");
+    if(!is_plugin_algorithm(alg) && strstr(get_algorithm_id(alg), "quicksort") != NULL)
+        fprintf(f, "Partitioning: %s\n", get_partition_id(opts->partition));
+    if(!is_plugin_algorithm(alg) && strstr(get_algorithm_id(alg), "network") != NULL)
+        fprintf(f, "Sorting network leaves: up to %d elements  |  instruction set: %s\n", opts->network_leaf_size, get_network_isa_id(get_sorting_network_isa()));
+    fprintf(f, "Number of executions per array case and size: %d\n", opts->num_executions);
+    if(opts->seed_set)
+        fprintf(f, "Seed: %u\n", opts->seed);
+    if(opts->use_statistics)
+        fprintf(f, "Statistics mode: %d warmup run(s)  |  min. measured runs per array: %d  |  max. measured runs per array: %d (0 = no limit)  |  target relative error: %.2lf%%\n",
+                opts->config.warmup_runs, opts->config.min_runs, opts->config.max_runs, 100 * opts->config.target_relative_error);
+    if(opts->budget.cell_seconds > 0 || opts->budget.total_seconds > 0 || opts->budget.timeout_seconds > 0)
+        fprintf(f, "Time budget: %.2lfs per cell  |  %.2lfs in total  |  timeout: %.2lfs (0 = no limit)\n", opts->budget.cell_seconds, opts->budget.total_seconds, opts->budget.timeout_seconds);
+
+    for(int c = 0; c < NUM_CASES; c++) {
+        if(!opts->cases[c])
+            continue;
+        if(c == ALMOST_SORTED_CASE)
+            fprintf(f, "\n-> %s (k = %d):\n", get_case_name(c), opts->almost_sorted_k);
+        else
+            fprintf(f, "\n-> %s:\n", get_case_name(c));
+        fprint_case(f, results[c], alg, opts->sizes);
+    }
+
+    bool failed = ferror(f);
+    if(fclose(f) != 0 || failed) {
+        fprintf(stderr, "Couldn't write to \"%s\"!\n", path);
+        return BATCH_IO_ERROR;
+    }
+    return BATCH_OK;
+}
+
+/*
+ * External sort mode: sorts the input file once with each of the selected algorithms generating the runs and saves the performance of each one to "external_sort.txt".
+ */
+static int run_external_sort(BatchOptions *opts)
+{
+    if(!opts->algorithms_set) {
+        memset(opts->algorithms, 0, sizeof(opts->algorithms));
+        opts->algorithms[find_algorithm("quicksort")] = opts->algorithms[find_algorithm("merge_sort_bottom_up")] = opts->algorithms[find_algorithm("lsd_radix_sort")] = true;
+    }
+    if(opts->external_output[0] == '\0')
+        snprintf(opts->external_output, sizeof(opts->external_output), "%.*s.sorted", (int) sizeof(opts->external_output) - 8, opts->external_input);
+    if(opts->temp_dir[0] == '\0')
+        strcpy(opts->temp_dir, opts->output_dir);
+
+    if(opts->generate_input > 0) {
+        printf("-> Writing %zu random ints to \"%s\"...\n", opts->generate_input, opts->external_input);
+        if(!generate_random_file(opts->external_input, opts->generate_input)) {
+            fprintf(stderr, "Couldn't write \"%s\"!\n", opts->external_input);
+            return BATCH_IO_ERROR;
+        }
+    }
+
+    char path[PATH_MAX + 64];
+    snprintf(path, sizeof(path), "%s/external_sort.txt", opts->output_dir);
+    FILE *f = fopen(path, "w");
+    if(f == NULL) {
+        fprintf(stderr, "Couldn't open \"%s\" for writing!\n", path);
+        return BATCH_IO_ERROR;
+    }
+    time_now_to_file(f);
+    fprintf(f, "Input: %s\nMemory budget: %zu MiB  |  Fan-in: %d\n", opts->external_input, opts->memory_mb, opts->fan_in);
+
+    int status = BATCH_OK;
+    for(int i = 0; i < get_num_algorithms() && status == BATCH_OK; i++) {
+        if(!opts->algorithms[i])
+            continue;
+        if(get_algorithm_sort(i, true) == NULL) {
+            printf("-> Skipping %s: the runs can only be generated by the built-in algorithms\n", get_algorithm_name(i));
+            continue;
+        }
+
+        printf("-> External sort with %s generating the runs...\n", get_algorithm_name(i));
+        ExternalSortInfo *info = external_sort(opts->external_input, opts->external_output, opts->temp_dir, opts->memory_mb << 20, opts->fan_in, (get_algorithm_properties(i) & SORT_IN_PLACE) != 0,
+                                               get_algorithm_sort(i, false), get_algorithm_sort(i, true));
+        if(info == NULL) {
+            status = BATCH_IO_ERROR;
+            break;
+        }
+        if(!is_file_sorted(opts->external_output)) {
+            fprintf(stderr, "\nERROR: the external sort with %s didn't sort the file correctly!\n", get_algorithm_name(i));
+            status = BATCH_SORT_FAILED;
+        }
+        else
+            printf("\t-> OK! (%.6lfs | %d runs of up to %zu ints | %d passes)\n", get_external_time(info), get_external_num_runs(info), get_external_run_length(info), get_external_num_passes(info));
+
+        fprintf(f, "\n-> %s%s:\n", get_algorithm_name(i), (status == BATCH_SORT_FAILED) ? " (FAILED: the output isn't sorted)" : "");
+        fprint_external_sort_info(f, info);
+        free_external_sort_info(info);
+    }
+
+    bool failed = ferror(f);
+    if((fclose(f) != 0 || failed) && status == BATCH_OK) {
+        fprintf(stderr, "Couldn't write to \"%s\"!\n", path);
+        status = BATCH_IO_ERROR;
+    }
+    if(status == BATCH_OK)
+        printf("\nDone! Sorted file saved to \"%s\" and results saved to \"%s\".\n", opts->external_output, path);
+    return status;
+}
+
+/*
+ * Saves the scaling report of every case that ran (see complexity.h) to "complexity.txt" in the output directory.
+ */
+static int save_complexity_report(const BatchOptions *opts, CaseResults *results[NUM_ELEMENT_TYPES][NUM_CASES])
+{
+    char path[PATH_MAX + 64];
+    snprintf(path, sizeof(path), "%s/complexity.txt", opts->output_dir);
+    FILE *f = fopen(path, "w");
+    if(f == NULL) {
+        fprintf(stderr, "Couldn't open \"%s\" for writing!\n", path);
+        return BATCH_IO_ERROR;
+    }
+
+    time_now_to_file(f);
+    fprintf(f, "Scaling of the time (mean of the zero-overhead runs), comparisons and swaps with the size n of the arrays: a free power law and the\n"
+               "candidate models, fitted on a log-log scale (constant and typical relative error of each), and the sizes where the times cross.\n");
+    for(int t = 0; t < NUM_ELEMENT_TYPES; t++) {
+        for(int c = 0; c < NUM_CASES; c++) {
+            if(results[t][c] == NULL)
+                continue;
+            fprintf(f, "\n-> %s (%s):\n", get_case_name(c), get_element_type_name(t));
+            fprint_complexity_report(f, results[t][c], t, opts->sizes, opts->num_sizes, opts->algorithms);
+        }
+    }
+
+    if(fclose(f) != 0) {
+        fprintf(stderr, "Couldn't write the results to \"%s\"!\n", path);
+        return BATCH_IO_ERROR;
+    }
+    return BATCH_OK;
+}
+
+/*
+ * Saves the time samples of every measured cell of the run as the baseline opts->save_baseline (see baseline.h).
+ */
+static int save_baseline(const BatchOptions *opts, CaseResults *results[NUM_ELEMENT_TYPES][NUM_CASES])
+{
+    char path[PATH_MAX + MAX_BASELINE_NAME + 16];
+    snprintf(path, sizeof(path), "%s/%s.baseline", opts->baseline_dir, opts->save_baseline);
+    if(mkdir(opts->baseline_dir, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Couldn't create the baselines directory \"%s\"!\n", opts->baseline_dir);
+        return BATCH_IO_ERROR;
+    }
+
+    Baseline *baseline = baseline_new();
+    for(int t = 0; t < NUM_ELEMENT_TYPES; t++) {
+        for(int c = 0; c < NUM_CASES; c++) {
+            for(int a = 0; a < get_num_algorithms() && results[t][c] != NULL; a++) {
+                for(int j = 0; j < opts->num_sizes && opts->algorithms[a] && is_algorithm_available(t, a); j++) {
+                    if(get_case_result_state(results[t][c], a, j, NULL) == CELL_MEASURED)
+                        baseline_add(baseline, get_element_type_id(t), get_case_id(c), get_algorithm_id(a), opts->sizes[j], get_time_samples(get_case_result(results[t][c], a, j)));
+                }
+            }
+        }
+    }
+
+    bool saved = baseline_save(baseline, path);
+    baseline_free(baseline);
+    if(!saved) {
+        fprintf(stderr, "Couldn't save the baseline to \"%s\"!\n", path);
+        return BATCH_IO_ERROR;
+    }
+    printf("\nBaseline saved to \"%s\".\n", path);
+    return BATCH_OK;
+}
+
+/*
+ * Prints (to stdout and to "regressions.txt" in the output directory) the change of every cell of the run in relation to the given baseline: the median times, the speedup and the p-value of the Mann-Whitney U test (see compare_to_baseline).
+ * A cell that timed out but was measured in the baseline also counts as a regression. Returns BATCH_REGRESSION if any cell regressed.
+ */
+static int compare_with_baseline(const BatchOptions *opts, const Baseline *baseline, CaseResults *results[NUM_ELEMENT_TYPES][NUM_CASES])
+{
+    static const char *VERDICTS[] = {"no significant change", "REGRESSION", "improvement", "too few samples"};
+    char path[PATH_MAX + 64];
+    snprintf(path, sizeof(path), "%s/regressions.txt", opts->output_dir);
+    FILE *f = fopen(path, "w");
+    if(f == NULL) {
+        fprintf(stderr, "Couldn't open \"%s\" for writing!\n", path);
+        return BATCH_IO_ERROR;
+    }
+
+    FILE *outputs[] = {stdout, f};
+    for(int o = 0; o < 2; o++)
+        fprintf(outputs[o], "\nComparison with the baseline \"%s\" (regression: %.1lf%% slower with p < %.3lf):\n", opts->compare_baseline, 100 * opts->regression_threshold, opts->significance);
+
+    int counts[4] = {0}, not_compared = 0;
+    for(int t = 0; t < NUM_ELEMENT_TYPES; t++) {
+        for(int c = 0; c < NUM_CASES; c++) {
+            if(results[t][c] == NULL)
+                continue;
+            for(int o = 0; o < 2; o++)
+                fprintf(outputs[o], "\n-> %s (%s):\n", get_case_name(c), get_element_type_name(t));
+
+            for(int a = 0; a < get_num_algorithms(); a++) {
+                for(int j = 0; j < opts->num_sizes && opts->algorithms[a] && is_algorithm_available(t, a); j++) {
+                    const Samples *old = baseline_find(baseline, get_element_type_id(t), get_case_id(c), get_algorithm_id(a), opts->sizes[j]);
+                    int state = get_case_result_state(results[t][c], a, j, NULL);
+                    for(int o = 0; o < 2; o++) {
+                        fprintf(outputs[o], "\t< %s  |  SIZE: %zu  |  ", get_algorithm_id(a), opts->sizes[j]);
+                        if(old == NULL)
+                            fprintf(outputs[o], "not in the baseline >\n");
+                        else if(state == CELL_TIMED_OUT)
+                            fprintf(outputs[o], "TIMED OUT: REGRESSION >\n");
+                        else if(state == CELL_SKIPPED)
+                            fprintf(outputs[o], "skipped >\n");
+                        else if(state == CELL_NO_MEMORY)
+                            fprintf(outputs[o], "skipped (not enough memory) >\n");
+                    }
+                    if(old == NULL || state == CELL_SKIPPED || state == CELL_NO_MEMORY) {
+                        not_compared++;
+                        continue;
+                    }
+                    if(state == CELL_TIMED_OUT) {
+                        counts[BASELINE_REGRESSED]++;
+                        continue;
+                    }
+
+                    BaselineComparison cmp = compare_to_baseline(old, get_time_samples(get_case_result(results[t][c], a, j)), opts->regression_threshold, opts->significance);
+                    counts[cmp.verdict]++;
+                    for(int o = 0; o < 2; o++)
+                        fprintf(outputs[o], "BASELINE: %.8lfs  |  NOW: %.8lfs (medians)  |  %.3lfx %s  |  p = %.4lf  |  %s >\n", cmp.baseline_median, cmp.current_median,
+                                (cmp.speedup >= 1) ? cmp.speedup : 1 / cmp.speedup, (cmp.speedup >= 1) ? "faster" : "slower", cmp.p_value, VERDICTS[cmp.verdict]);
+                }
+            }
+        }
+    }
+
+    for(int o = 0; o < 2; o++)
+        fprintf(outputs[o], "\n%d regression(s), %d improvement(s), %d cell(s) without a significant change, %d cell(s) with too few samples and %d cell(s) not compared.\n",
+                counts[BASELINE_REGRESSED], counts[BASELINE_IMPROVED], counts[BASELINE_UNCHANGED], counts[BASELINE_TOO_FEW_SAMPLES], not_compared);
+    if(fclose(f) != 0) {
+        fprintf(stderr, "Couldn't write the comparison to \"%s\"!\n", path);
+        return BATCH_IO_ERROR;
+    }
+    return (counts[BASELINE_REGRESSED] > 0) ? BATCH_REGRESSION : BATCH_OK;
+}
+
+int run_batch(int argc, char **argv)
+{
+    //default settings
+    BatchOptions opts = {.num_sizes = 5, .sizes = {100, 1000, 10000, 100000, 1000000}, .num_executions = 1, .num_workers = 1, .num_threads = 0,
+                         .almost_sorted_k = 10, .network_leaf_size = 32, .network_isa = NETWORK_ISA_AUTO, .partition = HOARE_PARTITION, .gap_sequence = CIURA_GAPS, .shellsort_threads = 1, .generator_threads = 0, .huge_pages = HUGE_PAGES_OFF, .random_swaps = 0, .heap = {.arity = 2, .bottom_up = false, .prefetch = false}, .pin_workers = false, .use_statistics = false, .seed_set = false,
+                         .config = {.warmup_runs = 1, .min_runs = 5, .max_runs = 100, .target_relative_error = 0.01}, .output_dir = "./results", .dataset_cache_dir = "",
+                         .algorithms_set = false, .external_input = "", .external_output = "", .temp_dir = "", .generate_input = 0, .memory_mb = 256, .fan_in = 64,
+                         .budget = {0, 0, 0}, .save_baseline = "", .compare_baseline = "", .baseline_dir = "./baselines", .regression_threshold = 0.05, .significance = 0.05};
+    for(int i = 0; i < get_num_algorithms(); i++)
+        opts.algorithms[i] = true;
+    for(int c = 0; c < NUM_CASES; c++)
+        opts.cases[c] = true;
+    opts.types[INT_ELEMENTS] = true;
+
+    //parsing the arguments
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--help") == 0) {
+            print_usage(stdout, argv[0]);
+            return BATCH_OK;
+        }
+
+        if(strncmp(argv[i], "--", 2) != 0) {
+            fprintf(stderr, "Unexpected argument: \"%s\"\n\n", argv[i]);
+            print_usage(stderr, argv[0]);
+            return BATCH_BAD_ARGUMENTS;
+        }
+
+        const char *arg = argv[i], *key = arg + 2;
+        int taken = set_option(&opts, key, NULL);
+        if(taken < 0 && i + 1 < argc)
+            taken = set_option(&opts, key, argv[++i]);
+        if(taken < 0) {
+            fprintf(stderr, "Invalid option or value: \"%s\"\n\n", arg);
+            print_usage(stderr, argv[0]);
+            return BATCH_BAD_ARGUMENTS;
+        }
+    }
+
+    if(opts.use_statistics && opts.config.max_runs > 0 && opts.config.max_runs < opts.config.min_runs) {
+        fprintf(stderr, "The maximum number of runs can't be lower than the minimum number of runs!\n");
+        return BATCH_BAD_ARGUMENTS;
+    }
+
+    if(mkdir(opts.output_dir, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Couldn't create the output directory \"%s\"!\n", opts.output_dir);
+        return BATCH_IO_ERROR;
+    }
+
+    if(opts.seed_set)
+        set_random_seed(opts.seed);
+    if(!set_dataset_cache_dir(opts.dataset_cache_dir)) {
+        fprintf(stderr, "Couldn't create the dataset cache directory \"%s\"!\n", opts.dataset_cache_dir);
+        return BATCH_IO_ERROR;
+    }
+    if(opts.dataset_cache_dir[0] != '\0' && !opts.seed_set)
+        fprintf(stderr, "WARNING: the arrays are only loaded from the dataset cache by runs with the same seed, but no --seed was given.\n");
+    set_quicksort_partition(opts.partition);
+    set_heap_variant(opts.heap);
+    set_shellsort_gaps(opts.gap_sequence);
+    set_shellsort_threads(opts.shellsort_threads);
+    if(opts.external_input[0] != '\0')
+        return run_external_sort(&opts);
+
+    if(!set_sorting_network_isa(opts.network_isa)) {
+        fprintf(stderr, "The CPU doesn't support the \"%s\" sorting networks!\n", get_network_isa_id(opts.network_isa));
+        return BATCH_BAD_ARGUMENTS;
+    }
+
+    //sorting
+    set_parallel_quicksort_threads(opts.num_threads);
+    set_network_leaf_size(opts.network_leaf_size);
+    set_almost_sorted_k(opts.almost_sorted_k);
+    set_random_swaps(opts.random_swaps);
+    set_generator_threads(opts.generator_threads);
+    set_huge_pages(opts.huge_pages);
+
+    //the baseline is loaded before the benchmarks, so that a bad name doesn't waste a whole run
+    Baseline *baseline = NULL;
+    if(opts.compare_baseline[0] != '\0') {
+        char path[PATH_MAX + MAX_BASELINE_NAME + 16];
+        snprintf(path, sizeof(path), "%s/%s.baseline", opts.baseline_dir, opts.compare_baseline);
+        if((baseline = baseline_load(path)) == NULL)
+            return BATCH_IO_ERROR;
+    }
+    int samples_per_cell = opts.num_executions * (opts.use_statistics ? opts.config.min_runs : 1);
+    if((opts.compare_baseline[0] != '\0' || opts.save_baseline[0] != '\0') && samples_per_cell < MIN_BASELINE_SAMPLES)
+        fprintf(stderr, "WARNING: the cells need at least %d time samples to be compared with a baseline (use --executions %d or the statistics mode).\n", MIN_BASELINE_SAMPLES, MIN_BASELINE_SAMPLES);
+
+    //the records of each execution are streamed to these files as soon as they're measured
+    char csv_path[PATH_MAX + 64], jsonl_path[PATH_MAX + 64];
+    snprintf(csv_path, sizeof(csv_path), "%s/results.csv", opts.output_dir);
+    snprintf(jsonl_path, sizeof(jsonl_path), "%s/results.jsonl", opts.output_dir);
+    ResultsWriter *writer = results_writer_open(csv_path, jsonl_path);
+    if(writer == NULL) {
+        fprintf(stderr, "Couldn't open \"%s\" and \"%s\" for writing!\n", csv_path, jsonl_path);
+        if(baseline != NULL)
+            baseline_free(baseline);
+        return BATCH_IO_ERROR;
+    }
+
+    CaseResults *results[NUM_ELEMENT_TYPES][NUM_CASES] = {{NULL}};
+    set_time_budget(opts.budget); //the total budget starts counting here
+    for(int t = 0; t < NUM_ELEMENT_TYPES; t++) {
+        for(int c = 0; c < NUM_CASES && opts.types[t]; c++) {
+            if(!opts.cases[c])
+                continue;
+            printf("-> %s (%s):\n", get_case_name(c), get_element_type_name(t));
+            results[t][c] = analyze_case(t, c, opts.sizes, opts.num_sizes, opts.algorithms, opts.num_executions,
+                                         opts.num_workers, opts.pin_workers, opts.use_statistics ? &opts.config : NULL, writer);
+        }
+    }
+
+    //saving
+    int status = BATCH_OK;
+    if(!results_writer_close(writer)) {
+        fprintf(stderr, "Couldn't write all the records to \"%s\" and \"%s\"!\n", csv_path, jsonl_path);
+        status = BATCH_IO_ERROR;
+    }
+    for(int t = 0; t < NUM_ELEMENT_TYPES; t++) {
+        for(int i = 0; i < get_num_algorithms() && status == BATCH_OK; i++) {
+            if(opts.types[t] && opts.algorithms[i] && is_algorithm_available(t, i))
+                status = save_results(&opts, t, i, results[t]);
+        }
+    }
+    if(status == BATCH_OK)
+        status = save_complexity_report(&opts, results);
+    if(status == BATCH_OK && baseline != NULL)
+        status = compare_with_baseline(&opts, baseline, results);
+    if((status == BATCH_OK || status == BATCH_REGRESSION) && opts.save_baseline[0] != '\0') {
+        int saved = save_baseline(&opts, results);
+        status = (saved != BATCH_OK) ? saved : status;
+    }
+    if(baseline != NULL)
+        baseline_free(baseline);
+
+    for(int t = 0; t < NUM_ELEMENT_TYPES; t++) {
+        for(int c = 0; c < NUM_CASES; c++) {
+            if(results[t][c] != NULL)
+                free_case_results(results[t][c]);
+        }
+    }
+
+    if(status == BATCH_OK || status == BATCH_REGRESSION)
+        printf("\nDone! Results saved to \"%s\".\n", opts.output_dir);
+    return status;
+}
@@ -0,0 +1,25 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef BATCH_MODE_H
+    #define BATCH_MODE_H
+
+    /*
+     * Exit codes of the batch mode.
+     */
+    #define BATCH_OK 0
+    #define BATCH_SORT_FAILED 1 //an algorithm didn't sort its input (the workers exit with this code)
+    #define BATCH_BAD_ARGUMENTS 2
+    #define BATCH_IO_ERROR 3
+    #define BATCH_OUT_OF_MEMORY 4 //a buffer needed by a sort couldn't be allocated (same as EXIT_OUT_OF_MEMORY)
+    #define BATCH_REGRESSION 5 //a cell got significantly slower than in the baseline given to --compare-baseline
+
+    /*
+     * Runs the benchmarks described by the command line arguments, without any user interaction, and saves the results to the output directory.
+     * Returns one of the exit codes above. Run with "--help" for the list of options.
+     */
+    int run_batch(int argc, char **argv);
+
+#endif
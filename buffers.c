@@ -0,0 +1,102 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include "buffers.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define HUGE_PAGE_SIZE ((size_t) 2 << 20) //size of the huge pages (2 MiB on x86-64 and most of arm64 systems)
+
+static const char *HUGE_PAGES_IDS[NUM_HUGE_PAGE_MODES] = {"off", "thp", "hugetlb"};
+
+static int huge_pages = HUGE_PAGES_OFF; //pages used by the buffers (see set_huge_pages)
+static bool hugetlb_warned = false; //true after warning that MAP_HUGETLB failed
+
+/*
+ * Selects the pages backing the buffers allocated from now on. Not thread-safe: must be called before any benchmark starts.
+ */
+void set_huge_pages(int mode) {huge_pages = mode;}
+int get_huge_pages(void) {return huge_pages;}
+const char* get_huge_pages_id(int mode) {return HUGE_PAGES_IDS[mode];}
+
+/*
+ * Returns the huge pages mode with the given id or -1 if there's no such mode.
+ */
+int find_huge_pages(const char *id)
+{
+    for(int i = 0; i < NUM_HUGE_PAGE_MODES; i++) {
+        if(strcmp(HUGE_PAGES_IDS[i], id) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static size_t round_up(size_t x, size_t multiple) {
+    return (x + multiple - 1) / multiple * multiple;
+}
+
+/*
+ * Allocates a buffer of "count" elements of "elem_size" bytes (see Buffer), backed by anonymous memory with the pages selected by set_huge_pages. Returns false if there isn't enough memory (or the size overflows).
+ * With transparent huge pages, the data starts at a huge page boundary (the mapping gets an extra huge page to make room for the alignment) and is marked with MADV_HUGEPAGE before being touched, so the kernel backs it with huge pages from the first fault.
+ */
+bool alloc_buffer(Buffer *buffer, size_t count, size_t elem_size)
+{
+    *buffer = (Buffer) {NULL, 0, NULL, 0};
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    if(elem_size > 0 && count > (SIZE_MAX - 2*HUGE_PAGE_SIZE) / elem_size)
+        return false;
+    size_t bytes = count * elem_size, len = round_up((bytes > 0) ? bytes : 1, page_size);
+
+    if(huge_pages == HUGE_PAGES_HUGETLB) {
+        size_t huge_len = round_up(len, HUGE_PAGE_SIZE);
+        void *p = mmap(NULL, huge_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+        if(p != MAP_FAILED) {
+            *buffer = (Buffer) {p, bytes, p, huge_len};
+            return true;
+        }
+        if(!hugetlb_warned)
+            fprintf(stderr, "WARNING: not enough huge pages reserved for MAP_HUGETLB, using transparent huge pages.\n");
+        hugetlb_warned = true;
+    }
+
+    bool thp = huge_pages != HUGE_PAGES_OFF;
+    size_t mapping_len = thp ? len + HUGE_PAGE_SIZE : len;
+    void *p = mmap(NULL, mapping_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(p == MAP_FAILED)
+        return false;
+
+    char *data = p;
+    if(thp) {
+        data = (char*) round_up((uintptr_t) p, HUGE_PAGE_SIZE);
+        madvise(data, len, MADV_HUGEPAGE);
+    }
+
+    *buffer = (Buffer) {data, bytes, p, mapping_len};
+    prefault_buffer(buffer);
+    return true;
+}
+
+/*
+ * Writes to every page of the buffer, so that touching it later doesn't fault. Also needed after a fork, when the pages of the child are shared copy-on-write with the parent. The contents of the buffer are lost.
+ */
+void prefault_buffer(Buffer *buffer)
+{
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    for(size_t i = 0; i < buffer->bytes; i += page_size)
+        ((volatile char*) buffer->data)[i] = 0;
+}
+
+/*
+ * Frees a buffer allocated by alloc_buffer. Does nothing if it's empty.
+ */
+void free_buffer(Buffer *buffer)
+{
+    if(buffer->mapping != NULL)
+        munmap(buffer->mapping, buffer->mapping_len);
+    *buffer = (Buffer) {NULL, 0, NULL, 0};
+}
@@ -0,0 +1,38 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef BUFFERS_H
+    #define BUFFERS_H
+    #include <stdbool.h>
+    #include <stddef.h>
+
+    /*
+     * Pages backing the benchmark buffers: regular pages (the default), transparent huge pages (madvise) or explicit huge pages (MAP_HUGETLB, which need pages reserved in /proc/sys/vm/nr_hugepages; if there aren't enough, transparent huge pages are used).
+     */
+    #define HUGE_PAGES_OFF 0
+    #define HUGE_PAGES_THP 1
+    #define HUGE_PAGES_HUGETLB 2
+    #define NUM_HUGE_PAGE_MODES 3
+
+    void set_huge_pages(int mode);
+    int get_huge_pages(void);
+    const char* get_huge_pages_id(int mode);
+    int find_huge_pages(const char *id);
+
+    /*
+     * A benchmark buffer (inputs and work arrays): "data" is aligned to BUFFER_ALIGNMENT bytes (to a huge page, if they're used) and all of its pages are faulted in when it's allocated, so that no page fault happens inside a timed region.
+     */
+    #define BUFFER_ALIGNMENT 64
+    typedef struct {
+        void *data;
+        size_t bytes;
+        void *mapping; //start and length of the underlying mapping
+        size_t mapping_len;
+    } Buffer;
+
+    bool alloc_buffer(Buffer *buffer, size_t count, size_t elem_size);
+    void prefault_buffer(Buffer *buffer);
+    void free_buffer(Buffer *buffer);
+#endif
@@ -0,0 +1,206 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include "complexity.h"
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+#define TIME_METRIC 0
+#define COMPARISONS_METRIC 1
+#define SWAPS_METRIC 2
+#define NUM_METRICS 3
+
+#define EXTRAPOLATION_RANGE 10 //crossovers of the fits are only reported up to this factor beyond the measured sizes
+
+static const char *MODEL_NAMES[NUM_COMPLEXITY_MODELS] = {"n", "n log2 n", "n^1.5", "n^2"};
+static const char *METRIC_NAMES[NUM_METRICS] = {"TIME", "COMPARISONS", "SWAPS"};
+
+const char* get_complexity_model_name(int model) {return MODEL_NAMES[model];}
+
+/*
+ * Returns f(n) of the given model (see complexity.h).
+ */
+double complexity_model(int model, double n)
+{
+    switch(model) {
+        case LINEAR_MODEL: return n;
+        case N_LOG_N_MODEL: return n * log2(n);
+        case N_1_5_MODEL: return n * sqrt(n);
+        default: return n * n;
+    }
+}
+
+/*
+ * Fits a cost to the sizes of the arrays (see ComplexityFit). The sizes below 2 (where n log2 n vanishes) and the non-positive costs are ignored.
+ * The constant of a model is the geometric mean of cost / f(n), which minimizes the squared log residuals.
+ */
+ComplexityFit fit_complexity(const double *sizes, const double *costs, int count)
+{
+    ComplexityFit fit = {.num_points = 0, .law = {NAN, NAN}, .best_model = -1};
+    double *x = malloc(count * sizeof(double));  assert(x != NULL);
+    double *y = malloc(count * sizeof(double));  assert(y != NULL);
+    for(int i = 0; i < count; i++) {
+        if(sizes[i] >= 2 && costs[i] > 0) {
+            x[fit.num_points] = sizes[i];
+            y[fit.num_points++] = costs[i];
+        }
+    }
+
+    if(fit.num_points >= 2) {
+        fit.law = fit_power_law(x, y, fit.num_points);
+        for(int m = 0; m < NUM_COMPLEXITY_MODELS; m++) {
+            double log_constant = 0, squares = 0;
+            for(int i = 0; i < fit.num_points; i++)
+                log_constant += log(y[i] / complexity_model(m, x[i]));
+            log_constant /= fit.num_points;
+            for(int i = 0; i < fit.num_points; i++) {
+                double residual = log(y[i] / complexity_model(m, x[i])) - log_constant;
+                squares += residual * residual;
+            }
+
+            fit.constants[m] = exp(log_constant);
+            fit.errors[m] = sqrt(squares / fit.num_points);
+            if(fit.best_model < 0 || fit.errors[m] < fit.errors[fit.best_model])
+                fit.best_model = m;
+        }
+    }
+
+    free(x);  free(y);
+    return fit;
+}
+
+/*
+ * Returns the cost of a cell of the results (0 if it has none).
+ */
+static double metric_value(SortingInfo *info, int metric)
+{
+    switch(metric) {
+        case TIME_METRIC: return get_execution_time(info);
+        case COMPARISONS_METRIC: return (double) get_comparisons_count(info);
+        default: return (double) get_swaps_count(info);
+    }
+}
+
+/*
+ * Prints the line of a metric of an algorithm: the fitted power law, the constant and the error of every model and the best model.
+ */
+static void fprint_fit(FILE *file, int metric, const ComplexityFit *fit)
+{
+    fprintf(file, "\t\t%s:", METRIC_NAMES[metric]);
+    if(fit->num_points < 2) {
+        fprintf(file, " n/a (fewer than 2 sizes with a non-zero value)\n");
+        return;
+    }
+    if(isnan(fit->law.exponent))
+        fprintf(file, " n/a");
+    else
+        fprintf(file, " ~ %.3e * n^%.3lf", fit->law.constant, fit->law.exponent);
+
+    for(int m = 0; m < NUM_COMPLEXITY_MODELS; m++)
+        fprintf(file, "  |  %s: %.3e (+-%.1lf%%)", MODEL_NAMES[m], fit->constants[m], 100 * (exp(fit->errors[m]) - 1));
+    fprintf(file, "  |  BEST: %s", MODEL_NAMES[fit->best_model]);
+    if(metric == TIME_METRIC)
+        fprintf(file, "  |  %.4lf ns per element per log2 n", 1e9 * fit->constants[N_LOG_N_MODEL]);
+    fprintf(file, "\n");
+}
+
+/*
+ * Prints the sizes where the times of algorithms a and b cross. Between two measured sizes where the faster one changes, the crossover is interpolated on a log-log scale. If that never happens, the crossover of their fitted power laws is printed instead, when it's within EXTRAPOLATION_RANGE of the measured sizes.
+ * "times" holds the time of each algorithm on each size (0 if not measured) and "order" the indexes of the sizes in ascending order. Returns the number of crossovers printed.
+ */
+static int fprint_crossovers(FILE *file, int a, int b, const double *times, const size_t *sizes, const int *order, int num_sizes, const ComplexityFit *fits)
+{
+    const double *ta = &times[a * num_sizes], *tb = &times[b * num_sizes];
+    int found = 0, last = -1; //last = the largest size (in "order") where both were measured
+    double last_diff = 0;
+    for(int o = 0; o < num_sizes; o++) {
+        int j = order[o];
+        if(ta[j] <= 0 || tb[j] <= 0)
+            continue;
+
+        double diff = log(ta[j] / tb[j]); //negative while a is faster
+        if(last >= 0 && (last_diff < 0) != (diff < 0) && diff != 0) {
+            double lo = log(sizes[order[last]]), hi = log(sizes[j]);
+            double crossover = exp(lo + (hi - lo) * last_diff / (last_diff - diff));
+            int faster = (last_diff < 0) ? a : b, slower = (faster == a) ? b : a;
+            fprintf(file, "\t\t%s is faster below n = %.0lf, %s above it\n", get_algorithm_name(faster), crossover, get_algorithm_name(slower));
+            found++;
+        }
+        last = o;  last_diff = diff;
+    }
+
+    const PowerLaw *la = &fits[a].law, *lb = &fits[b].law;
+    if(found > 0 || fits[a].num_points < 2 || fits[b].num_points < 2 || isnan(la->exponent) || isnan(lb->exponent) || fabs(la->exponent - lb->exponent) < 0.05)
+        return found;
+
+    double crossover = pow(lb->constant / la->constant, 1 / (la->exponent - lb->exponent));
+    double min_size = sizes[order[0]], max_size = sizes[order[num_sizes - 1]];
+    if(crossover < 2 || crossover < min_size / EXTRAPOLATION_RANGE || crossover > max_size * EXTRAPOLATION_RANGE)
+        return found;
+
+    int faster = (la->exponent < lb->exponent) ? b : a, slower = (faster == a) ? b : a; //the one that grows faster wins on the small sizes
+    fprintf(file, "\t\t%s is faster below n = %.0lf, %s above it (extrapolated from the fits)\n", get_algorithm_name(faster), crossover, get_algorithm_name(slower));
+    return 1;
+}
+
+/*
+ * Writes the scaling report of the algorithms of a case (see complexity.h).
+ */
+void fprint_complexity_report(FILE *file, CaseResults *results, int type, const size_t *sizes, int num_sizes, const bool *selected)
+{
+    int num_algorithms = get_num_algorithms();
+    double *x = malloc(num_sizes * sizeof(double));  assert(x != NULL);
+    double *costs = malloc(NUM_METRICS * num_sizes * sizeof(double));  assert(costs != NULL);
+    double *times = calloc(num_algorithms * num_sizes, sizeof(double));  assert(times != NULL);
+    ComplexityFit *time_fits = calloc(num_algorithms, sizeof(ComplexityFit));  assert(time_fits != NULL);
+    bool *ran = malloc(num_algorithms * sizeof(bool));  assert(ran != NULL);
+
+    //sorting the sizes in ascending order
+    int *order = malloc(num_sizes * sizeof(int));  assert(order != NULL);
+    for(int i = 0; i < num_sizes; i++) {
+        int j = i;
+        for(; j > 0 && sizes[order[j-1]] > sizes[i]; j--)
+            order[j] = order[j-1];
+        order[j] = i;
+        x[i] = sizes[i];
+    }
+
+    //fits of each algorithm
+    for(int a = 0; a < num_algorithms; a++) {
+        ran[a] = (selected == NULL || selected[a]) && is_algorithm_available(type, a);
+        if(!ran[a])
+            continue;
+
+        for(int j = 0; j < num_sizes; j++) {
+            bool measured = get_case_result_state(results, a, j, NULL) == CELL_MEASURED;
+            for(int m = 0; m < NUM_METRICS; m++)
+                costs[m*num_sizes + j] = measured ? metric_value(get_case_result(results, a, j), m) : 0;
+            times[a*num_sizes + j] = costs[TIME_METRIC*num_sizes + j];
+        }
+
+        fprintf(file, "\t< %s >\n", get_algorithm_name(a));
+        for(int m = 0; m < NUM_METRICS; m++) {
+            ComplexityFit fit = fit_complexity(x, &costs[m*num_sizes], num_sizes);
+            fprint_fit(file, m, &fit);
+            if(m == TIME_METRIC)
+                time_fits[a] = fit;
+        }
+    }
+
+    //crossovers between each pair of algorithms
+    fprintf(file, "\tCrossovers of the time:\n");
+    int found = 0;
+    for(int a = 0; a < num_algorithms; a++) {
+        for(int b = a + 1; b < num_algorithms; b++) {
+            if(ran[a] && ran[b])
+                found += fprint_crossovers(file, a, b, times, sizes, order, num_sizes, time_fits);
+        }
+    }
+    if(found == 0)
+        fprintf(file, "\t\tnone\n");
+
+    free(x);  free(costs);  free(times);  free(time_fits);  free(ran);  free(order);
+}
@@ -0,0 +1,42 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef COMPLEXITY_H
+    #define COMPLEXITY_H
+    #include <stdio.h>
+    #include "sorting_algorithms.h"
+    #include "statistics.h"
+
+    /*
+     * Candidate models of how a cost (time, comparisons or swaps) of a sort grows with the size n of the array: cost = constant * f(n), where f(n) is n, n log2 n, n^1.5 or n^2.
+     */
+    #define LINEAR_MODEL 0
+    #define N_LOG_N_MODEL 1
+    #define N_1_5_MODEL 2
+    #define QUADRATIC_MODEL 3
+    #define NUM_COMPLEXITY_MODELS 4
+
+    const char* get_complexity_model_name(int model);
+    double complexity_model(int model, double n);
+
+    /*
+     * Fit of a cost to the sizes of the arrays: a power law with a free exponent and each of the candidate models, all fitted by least squares on a log-log scale. The error of a model is the RMS of its log residuals, so exp(error) - 1 is its typical relative error.
+     * The best model is the one with the lowest error. If fewer than 2 sizes have a positive cost, num_points < 2 and nothing else is set.
+     */
+    typedef struct {
+        int num_points;
+        PowerLaw law;
+        double constants[NUM_COMPLEXITY_MODELS], errors[NUM_COMPLEXITY_MODELS];
+        int best_model;
+    } ComplexityFit;
+
+    ComplexityFit fit_complexity(const double *sizes, const double *costs, int count);
+
+    /*
+     * Writes the scaling of every algorithm that ran on the given results of a case (see analyze_case) to a file: the fits of its time, comparisons and swaps, its time in ns per element per log2 n and the sizes where its time crosses the time of another algorithm.
+     * "selected" is the same as the one given to analyze_case (NULL for all the algorithms). Only the measured cells are used (not the skipped or timed out ones).
+     */
+    void fprint_complexity_report(FILE *file, CaseResults *results, int type, const size_t *sizes, int num_sizes, const bool *selected);
+#endif
@@ -0,0 +1,182 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include "dataset_cache.h"
+#include "generators.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define DATASET_MAGIC "SORTDSET" //first 8 bytes of a cached array file
+#define DATASET_FORMAT_VERSION 1 //must be incremented whenever DatasetHeader changes
+#define DATASET_ID_LEN 24
+
+static char cache_dir[PATH_MAX] = ""; //directory of the cached arrays ("" = cache disabled)
+
+/*
+ * Header of a cached array file, followed by the elements (in the byte order of the machine that wrote them). Every field but the checksum is part of the key of the array.
+ * It's 128 bytes long, so the elements are aligned to a cache line in the mapping.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t format_version, elem_size;
+    char type_id[DATASET_ID_LEN], case_id[DATASET_ID_LEN];
+    uint64_t generator_version, size, seed, parameter, sample;
+    uint64_t checksum; //of the elements (see dataset_checksum)
+    uint64_t reserved[2];
+} DatasetHeader;
+
+_Static_assert(sizeof(DatasetHeader) == 128, "the elements of a cached array must start at byte 128");
+
+const char* get_dataset_cache_dir(void) {return (cache_dir[0] != '\0') ? cache_dir : NULL;}
+
+/*
+ * Sets the directory of the cached arrays (created if it doesn't exist yet). If "dir" is NULL or empty, the cache is disabled.
+ * Returns false (and disables the cache) if the directory couldn't be created.
+ */
+bool set_dataset_cache_dir(const char *dir)
+{
+    cache_dir[0] = '\0';
+    if(dir == NULL || dir[0] == '\0')
+        return true;
+
+    if(strlen(dir) >= sizeof(cache_dir) || (mkdir(dir, 0777) != 0 && errno != EEXIST))
+        return false;
+    strcpy(cache_dir, dir);
+    return true;
+}
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/*
+ * Checksum of the elements of a cached array, to detect truncated or corrupted files (not tampering). Four independent multiply-rotate lanes over 8-byte words, so it runs at memory speed.
+ */
+static uint64_t dataset_checksum(const void *data, size_t bytes)
+{
+    const unsigned char *p = data;
+    uint64_t h[4] = {0x243F6A8885A308D3ull, 0x13198A2E03707344ull, 0xA4093822299F31D0ull, 0x082EFA98EC4E6C89ull};
+    size_t i = 0;
+    for(; i + 32 <= bytes; i += 32) {
+        for(int l = 0; l < 4; l++) {
+            uint64_t w;
+            memcpy(&w, p + i + 8*l, sizeof(w));
+            h[l] = (rotl(h[l], 29) ^ w) * 0x9E3779B97F4A7C15ull;
+        }
+    }
+
+    uint64_t tail = bytes;
+    for(; i < bytes; i++)
+        tail = (tail ^ p[i]) * 0x100000001B3ull;
+    return (h[0] ^ rotl(h[1], 16) ^ rotl(h[2], 32) ^ rotl(h[3], 48) ^ tail) * 0x9E3779B97F4A7C15ull;
+}
+
+/*
+ * Fills the header (without the checksum) of the array with the given key.
+ */
+static void make_header(DatasetHeader *header, const char *type_id, size_t elem_size, int array_case, size_t size, int sample)
+{
+    memset(header, 0, sizeof(DatasetHeader));
+    memcpy(header->magic, DATASET_MAGIC, sizeof(header->magic));
+    header->format_version = DATASET_FORMAT_VERSION;
+    header->elem_size = elem_size;
+    strncpy(header->type_id, type_id, DATASET_ID_LEN - 1);
+    strncpy(header->case_id, get_case_id(array_case), DATASET_ID_LEN - 1);
+    header->generator_version = GENERATOR_VERSION;
+    header->size = size;
+    header->seed = get_random_seed();
+    header->parameter = get_case_parameter(array_case, size);
+    header->sample = sample;
+}
+
+/*
+ * Maps the cached array at "path" and copies its elements to "array", if it exists and matches the expected header. Returns false if it doesn't exist or is invalid (wrong key, size or checksum).
+ */
+static bool read_dataset(void *array, const char *path, const DatasetHeader *expected, size_t bytes)
+{
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    size_t len = sizeof(DatasetHeader) + bytes;
+    if(fstat(fd, &st) != 0 || (size_t) st.st_size != len) {
+        close(fd);
+        return false;
+    }
+
+    //MAP_POPULATE reads the whole file at once, instead of faulting each page in while the checksum is computed
+    void *mapping = mmap(NULL, len, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED)
+        return false;
+
+    DatasetHeader header;
+    memcpy(&header, mapping, sizeof(DatasetHeader));
+    uint64_t checksum = header.checksum;
+    header.checksum = 0;
+    const void *elements = (char*) mapping + sizeof(DatasetHeader);
+    bool valid = memcmp(&header, expected, sizeof(DatasetHeader)) == 0 && dataset_checksum(elements, bytes) == checksum;
+    if(valid)
+        memcpy(array, elements, bytes);
+    munmap(mapping, len);
+    return valid;
+}
+
+/*
+ * Saves an array to "path". The file is written under a temporary name and then renamed, so an interrupted run never leaves a partial file behind. Returns false if it couldn't be saved.
+ */
+static bool save_dataset(const char *path, const DatasetHeader *header, const void *array, size_t bytes)
+{
+    char temp_path[PATH_MAX + 192];
+    snprintf(temp_path, sizeof(temp_path), "%s.%ld.tmp", path, (long) getpid());
+    FILE *file = fopen(temp_path, "wb");
+    if(file == NULL)
+        return false;
+
+    bool ok = fwrite(header, sizeof(DatasetHeader), 1, file) == 1 && fwrite(array, 1, bytes, file) == bytes;
+    ok = (fclose(file) == 0) && ok;
+    if(!ok || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Writes the given sample of the array of the given element type, case and size to "array". If the cache is enabled and holds the array, it's copied from its (mapped) file; otherwise it's built by "generate" (and saved to the cache, if it's enabled).
+ * Returns true if the array came from the cache.
+ */
+bool load_dataset(const char *type_id, size_t elem_size, int array_case, size_t size, int sample, void *array,
+                  void (*generate)(void *array, int array_case, size_t size, int sample))
+{
+    size_t bytes = size * elem_size;
+
+    DatasetHeader header;
+    char path[PATH_MAX + 128];
+    bool use_cache = cache_dir[0] != '\0';
+    if(use_cache) {
+        make_header(&header, type_id, elem_size, array_case, size, sample);
+        snprintf(path, sizeof(path), "%s/%s_%s_n%zu_seed%llu_p%llu_s%d.bin", cache_dir, type_id, get_case_id(array_case), size,
+                 (unsigned long long) header.seed, (unsigned long long) header.parameter, sample);
+        if(read_dataset(array, path, &header, bytes))
+            return true;
+    }
+
+    generate(array, array_case, size, sample);
+    if(use_cache) {
+        header.checksum = dataset_checksum(array, bytes);
+        if(!save_dataset(path, &header, array, bytes))
+            fprintf(stderr, "WARNING: couldn't save the array to \"%s\".\n", path);
+    }
+    return false;
+}
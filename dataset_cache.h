@@ -0,0 +1,19 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef DATASET_CACHE_H
+    #define DATASET_CACHE_H
+    #include <stdbool.h>
+    #include <stddef.h>
+
+    /*
+     * On-disk cache of the generated input arrays. Each array is saved to its own file, named after its key (element type, case, size, seed, case parameter and sample), with a header that repeats the key and holds a checksum of the elements.
+     * Cached arrays are memory-mapped (read-only) and copied to the caller's buffer instead of being regenerated, so later runs with the same seed sort exactly the same bytes. The cache is disabled (every array is generated) unless a directory is set.
+     */
+    bool set_dataset_cache_dir(const char *dir);
+    const char* get_dataset_cache_dir(void);
+    bool load_dataset(const char *type_id, size_t elem_size, int array_case, size_t size, int sample, void *array,
+                      void (*generate)(void *array, int array_case, size_t size, int sample));
+#endif
@@ -0,0 +1,54 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+/*
+ * Example of a sort plugin (see sort_plugin.h): the C library's qsort, as a baseline for the built-in algorithms.
+ * Build it with "make example_plugin.so" and run it with e.g. "./program --plugin ./example_plugin.so --algorithms quicksort,libc_qsort".
+ */
+
+#include "sort_plugin.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+typedef struct {
+    int64_t key, value;
+} Record;
+
+static _Thread_local SortPluginCounters *counters = NULL; //counters of the sort running on this thread (NULL if they aren't counted)
+
+/*
+ * Defines the comparator and the sort function of an element type. The comparisons are counted through the thread-local pointer, since qsort's comparators take no context.
+ */
+#define DEFINE_QSORT(suffix, type, key) \
+    static int compare##suffix(const void *a, const void *b) { \
+        if(counters != NULL) \
+            counters->comparisons++; \
+        type x = *(const type*) a, y = *(const type*) b; \
+        return (key(x) > key(y)) - (key(x) < key(y)); \
+    } \
+    static void qsort##suffix(void *array, size_t size, SortPluginCounters *plugin_counters) { \
+        counters = plugin_counters; \
+        qsort(array, size, sizeof(type), &compare##suffix); \
+        counters = NULL; \
+    }
+
+#define VALUE(x) (x)
+#define KEY(x) ((x).key)
+
+DEFINE_QSORT(_int, int, VALUE)
+DEFINE_QSORT(_int64, int64_t, VALUE)
+DEFINE_QSORT(_float, float, VALUE)
+DEFINE_QSORT(_double, double, VALUE)
+DEFINE_QSORT(_kv, Record, KEY)
+
+static const SortPluginAlgorithm ALGORITHMS[] = {
+    {"libc_qsort", "C library qsort (plugin)", 0, &qsort_int, &qsort_int64, &qsort_float, &qsort_double, &qsort_kv}
+};
+
+static const SortPlugin PLUGIN = {SORT_PLUGIN_ABI_VERSION, sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]), ALGORITHMS};
+
+const SortPlugin* sort_plugin(void) {
+    return &PLUGIN;
+}
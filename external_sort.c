@@ -0,0 +1,375 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include "external_sort.h"
+#include "perf_counters.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define MIN_EXTERNAL_MEMORY (64 * 1024) //minimum memory budget, in bytes
+#define RUN_PATH_LEN 4096
+
+/*
+ * Struct to hold the information about the execution of an external sort.
+ */
+struct ExternalSortInfo {
+    double time, run_generation_time, merge_time; //wall clock times
+    long long int comparisons_count, swaps_count;
+    long long int bytes_read, bytes_written;
+    size_t num_elements, run_length; //run_length: elements sorted in memory at a time
+    int num_runs, num_passes;
+};
+
+// getters
+double get_external_time(ExternalSortInfo *info) {return info->time;}
+double get_external_run_generation_time(ExternalSortInfo *info) {return info->run_generation_time;}
+double get_external_merge_time(ExternalSortInfo *info) {return info->merge_time;}
+long long int get_external_comparisons_count(ExternalSortInfo *info) {return info->comparisons_count;}
+long long int get_external_swaps_count(ExternalSortInfo *info) {return info->swaps_count;}
+long long int get_external_bytes_read(ExternalSortInfo *info) {return info->bytes_read;}
+long long int get_external_bytes_written(ExternalSortInfo *info) {return info->bytes_written;}
+size_t get_external_num_elements(ExternalSortInfo *info) {return info->num_elements;}
+size_t get_external_run_length(ExternalSortInfo *info) {return info->run_length;}
+int get_external_num_runs(ExternalSortInfo *info) {return info->num_runs;}
+int get_external_num_passes(ExternalSortInfo *info) {return info->num_passes;}
+void free_external_sort_info(ExternalSortInfo *info) {free(info);}
+
+/*
+ * Opens a file for unbuffered I/O: all the reads and writes are done in big blocks, straight from/to our own buffers.
+ */
+static FILE* open_unbuffered(const char *path, const char *mode)
+{
+    FILE *file = fopen(path, mode);
+    if(file != NULL)
+        setvbuf(file, NULL, _IONBF, 0);
+    else
+        fprintf(stderr, "ERROR: couldn't open \"%s\"!\n", path);
+    return file;
+}
+
+/*
+ * Reads up to "count" ints from the file. Returns the number of ints read.
+ */
+static size_t read_ints(FILE *file, int *buffer, size_t count, ExternalSortInfo *info) {
+    size_t n = fread(buffer, sizeof(int), count, file);
+    info->bytes_read += n * sizeof(int);
+    return n;
+}
+
+/*
+ * Writes "count" ints to the file. Returns false if they couldn't be written.
+ */
+static bool write_ints(FILE *file, const int *buffer, size_t count, ExternalSortInfo *info) {
+    size_t n = fwrite(buffer, sizeof(int), count, file);
+    info->bytes_written += n * sizeof(int);
+    return n == count;
+}
+
+/*
+ * A sorted run being read by a merge: its file and a buffer with its next elements.
+ */
+typedef struct {
+    FILE *file;
+    int *buffer;
+    size_t pos, len;
+} MergeInput;
+
+/*
+ * Refills the buffer of an input. Returns false if the run has been fully read.
+ */
+static bool refill(MergeInput *input, size_t capacity, ExternalSortInfo *info) {
+    input->pos = 0;
+    input->len = read_ints(input->file, input->buffer, capacity, info);
+    return input->len > 0;
+}
+
+/*
+ * Restores the heap property of a min heap of inputs (ordered by their current element), assuming that only the input at the position i may be out of place.
+ */
+static void sift_down(MergeInput **heap, int size, int i, ExternalSortInfo *info)
+{
+    while(true) {
+        int smallest = i, left = 2*i + 1, right = 2*i + 2;
+        if(left < size && heap[left]->buffer[heap[left]->pos] < heap[smallest]->buffer[heap[smallest]->pos])
+            smallest = left;
+        if(right < size && heap[right]->buffer[heap[right]->pos] < heap[smallest]->buffer[heap[smallest]->pos])
+            smallest = right;
+        info->comparisons_count += 2;
+
+        if(smallest == i)
+            break;
+        MergeInput *temp = heap[i];  heap[i] = heap[smallest];  heap[smallest] = temp;
+        i = smallest;
+    }
+}
+
+/*
+ * Merges the sorted runs in "paths" into the file "output_path" with a k-way merge (a min heap of the current element of each run). The memory budget ("memory" ints, already allocated) is split evenly between the input buffers and the output buffer.
+ * Returns false if an I/O error happened.
+ */
+static bool merge_runs(char **paths, int k, const char *output_path, int *memory, size_t memory_len, ExternalSortInfo *info)
+{
+    size_t capacity = memory_len / (k + 1);
+    MergeInput *inputs = malloc(k * sizeof(MergeInput));  assert(inputs != NULL);
+    MergeInput **heap = malloc(k * sizeof(MergeInput*));  assert(heap != NULL);
+    int *output = memory + k*capacity;
+    size_t output_len = 0;
+    int heap_size = 0;
+    bool ok = true;
+
+    FILE *out = open_unbuffered(output_path, "wb");
+    ok = (out != NULL);
+    for(int r = 0; r < k; r++) {
+        inputs[r] = (MergeInput) {open_unbuffered(paths[r], "rb"), memory + r*capacity, 0, 0};
+        ok = ok && (inputs[r].file != NULL);
+        if(inputs[r].file != NULL && refill(&inputs[r], capacity, info))
+            heap[heap_size++] = &inputs[r];
+    }
+
+    for(int i = heap_size/2 - 1; ok && i >= 0; i--)
+        sift_down(heap, heap_size, i, info);
+
+    while(ok && heap_size > 0) {
+        MergeInput *top = heap[0];
+        output[output_len++] = top->buffer[top->pos++];
+        if(output_len == capacity) {
+            info->swaps_count += output_len; //every merged element is counted as a swap (move)
+            ok = write_ints(out, output, output_len, info);
+            output_len = 0;
+        }
+
+        //the run of the smallest element is advanced; it leaves the heap once it's been fully read
+        if(top->pos == top->len && !refill(top, capacity, info))
+            heap[0] = heap[--heap_size];
+        sift_down(heap, heap_size, 0, info);
+    }
+    info->swaps_count += output_len;
+    ok = ok && write_ints(out, output, output_len, info);
+
+    for(int r = 0; r < k; r++) {
+        if(inputs[r].file != NULL) {
+            ok = ok && !ferror(inputs[r].file);
+            fclose(inputs[r].file);
+        }
+    }
+    if(out != NULL && fclose(out) != 0)
+        ok = false;
+
+    free(inputs);  free(heap);
+    return ok;
+}
+
+/*
+ * Creates the name of a temporary run file.
+ */
+static char* run_path(const char *temp_dir, int pass, int run)
+{
+    char *path = malloc(RUN_PATH_LEN);  assert(path != NULL);
+    snprintf(path, RUN_PATH_LEN, "%s/external_sort_%d_p%d_r%d.bin", temp_dir, (int) getpid(), pass, run);
+    return path;
+}
+
+/*
+ * Returns a copy of the given path.
+ */
+static char* copy_path(const char *path) {
+    char *copy = malloc(strlen(path) + 1);  assert(copy != NULL);
+    return strcpy(copy, path);
+}
+
+/*
+ * Removes and frees the given run files.
+ */
+static void remove_runs(char **paths, int n) {
+    for(int i = 0; i < n; i++) {
+        remove(paths[i]);
+        free(paths[i]);
+    }
+}
+
+/*
+ * Sorts a binary file of native ints ("input_path") that may be larger than the memory, writing the sorted elements to "output_path".
+ * The input is read in chunks of "memory_bytes" (at least 64 KiB), each chunk is sorted in memory by "sort" (the zero-overhead version of an algorithm, so that the times don't include the counting) and spilled to a temporary run file in "temp_dir". If the algorithm isn't "in_place", it allocates a scratch buffer as big as the chunk, so the chunks are cut to half of the budget to keep both within it. The runs are then merged "fan_in" at a time, in as many passes as needed, with the same memory budget.
+ * The comparisons and swaps of the runs are counted afterwards, outside of the timed region, by sorting the same chunks again with "count_sort" (the instrumented version of the algorithm) in memory. If it's NULL, only the ones of the merges are counted.
+ * Returns NULL if the input can't be read or an I/O error happens (the temporary files are removed either way).
+ */
+ExternalSortInfo* external_sort(const char *input_path, const char *output_path, const char *temp_dir, size_t memory_bytes, int fan_in, bool in_place, SortingInfo* (*sort)(int *array, size_t size),
+                                   SortingInfo* (*count_sort)(int *array, size_t size))
+{
+    ExternalSortInfo *info = calloc(1, sizeof(ExternalSortInfo));  assert(info != NULL);
+    if(memory_bytes < MIN_EXTERNAL_MEMORY)
+        memory_bytes = MIN_EXTERNAL_MEMORY;
+
+    struct stat st;
+    if(stat(input_path, &st) != 0 || st.st_size % sizeof(int) != 0) {
+        fprintf(stderr, "ERROR: \"%s\" doesn't exist or isn't a file of ints!\n", input_path);
+        free(info);
+        return NULL;
+    }
+    info->num_elements = st.st_size / sizeof(int);
+
+    size_t memory_len = memory_bytes / sizeof(int);
+    if(fan_in < 2)
+        fan_in = 2;
+    if((size_t) fan_in > memory_len / 1024) //each buffer of a merge holds at least 1024 ints
+        fan_in = memory_len / 1024;
+    int *memory = checked_malloc(memory_len, sizeof(int));
+    size_t run_length = info->run_length = in_place ? memory_len : memory_len / 2;
+    bool single_run = (info->num_elements <= run_length); //the whole file fits in memory: it's sorted straight into the output
+    double starting_time = monotonic_time();
+
+    //RUN GENERATION: sorting chunks of the input in memory
+    int num_runs = 0, capacity = 16;
+    char **runs = malloc(capacity * sizeof(char*));  assert(runs != NULL);
+    FILE *in = open_unbuffered(input_path, "rb");
+    bool ok = (in != NULL);
+
+    size_t n;
+    while(ok && (n = read_ints(in, memory, run_length, info)) > 0) {
+        free_sorting_info(sort(memory, n));
+
+        if(num_runs == capacity) {
+            capacity *= 2;
+            runs = realloc(runs, capacity * sizeof(char*));  assert(runs != NULL);
+        }
+        char *path = runs[num_runs] = single_run ? copy_path(output_path) : run_path(temp_dir, 0, num_runs);
+        num_runs++;
+        FILE *out = open_unbuffered(path, "wb");
+        ok = (out != NULL) && write_ints(out, memory, n, info);
+        if(out != NULL && fclose(out) != 0)
+            ok = false;
+    }
+    if(in != NULL) {
+        ok = ok && !ferror(in);
+        fclose(in);
+    }
+
+    if(ok && num_runs == 0) { //empty input: the output is an empty file too
+        FILE *out = open_unbuffered(output_path, "wb");
+        ok = (out != NULL) && fclose(out) == 0;
+    }
+
+    info->num_runs = num_runs;
+    info->num_passes = 1;
+    info->run_generation_time = monotonic_time() - starting_time;
+
+    //MERGING: each pass merges groups of up to "fan_in" runs, until a single run (the output) is left
+    int pass = 1;
+    while(ok && num_runs > 1) {
+        int num_merged = (num_runs + fan_in - 1) / fan_in;
+        char **merged = malloc(num_merged * sizeof(char*));  assert(merged != NULL);
+
+        for(int g = 0; g < num_merged; g++) {
+            int first = g * fan_in, k = (num_runs - first < fan_in) ? num_runs - first : fan_in;
+            merged[g] = (num_merged == 1) ? copy_path(output_path) : run_path(temp_dir, pass, g);
+            ok = ok && merge_runs(&runs[first], k, merged[g], memory, memory_len, info);
+        }
+
+        remove_runs(runs, num_runs);
+        free(runs);
+        runs = merged;
+        num_runs = num_merged;
+        info->num_passes++;
+        pass++;
+    }
+
+    info->time = monotonic_time() - starting_time;
+    info->merge_time = info->time - info->run_generation_time;
+
+    //counting the comparisons and swaps of the runs (the chunks are the same, since the reads are unbuffered)
+    if(ok && count_sort != NULL) {
+        in = open_unbuffered(input_path, "rb");
+        ok = (in != NULL);
+        while(ok && (n = fread(memory, sizeof(int), run_length, in)) > 0) {
+            SortingInfo *run_info = count_sort(memory, n);
+            info->comparisons_count += get_comparisons_count(run_info);
+            info->swaps_count += get_swaps_count(run_info);
+            free_sorting_info(run_info);
+        }
+        if(in != NULL) {
+            ok = ok && !ferror(in);
+            fclose(in);
+        }
+    }
+
+    //the output (if it was created) isn't a temporary file
+    if(ok && num_runs == 1)
+        free(runs[0]);
+    else
+        remove_runs(runs, num_runs);
+    free(runs);
+    free(memory);
+
+    if(!ok) {
+        fprintf(stderr, "ERROR: the external sort of \"%s\" failed (I/O error or disk full)!\n", input_path);
+        free(info);
+        return NULL;
+    }
+    return info;
+}
+
+/*
+ * Writes a binary file with "size" random native ints (within the range [0, INT_MAX]), generated in chunks so that it can be larger than the memory.
+ * Returns false if the file couldn't be written.
+ */
+bool generate_random_file(const char *path, size_t size)
+{
+    const size_t CHUNK = 1 << 20;
+    int *buffer = checked_malloc(CHUNK, sizeof(int));
+
+    FILE *file = open_unbuffered(path, "wb");
+    bool ok = (file != NULL);
+    for(size_t written = 0; ok && written < size; written += CHUNK) {
+        size_t n = (size - written < CHUNK) ? size - written : CHUNK;
+        for(size_t i = 0; i < n; i++)
+            buffer[i] = next_random() >> 33;
+        ok = (fwrite(buffer, sizeof(int), n, file) == n);
+    }
+
+    if(file != NULL && fclose(file) != 0)
+        ok = false;
+    free(buffer);
+    return ok;
+}
+
+/*
+ * Returns true if the given binary file of ints is sorted (read in chunks). Returns false if it's not sorted or can't be read.
+ */
+bool is_file_sorted(const char *path)
+{
+    const size_t CHUNK = 1 << 20;
+    int *buffer = checked_malloc(CHUNK, sizeof(int));
+    FILE *file = open_unbuffered(path, "rb");
+    bool sorted = (file != NULL), first = true;
+    int last = 0;
+
+    size_t n;
+    while(sorted && (n = fread(buffer, sizeof(int), CHUNK, file)) > 0) {
+        sorted = (first || last <= buffer[0]) && is_sorted(buffer, n);
+        last = buffer[n - 1];
+        first = false;
+    }
+
+    if(file != NULL) {
+        sorted = sorted && !ferror(file);
+        fclose(file);
+    }
+    free(buffer);
+    return sorted;
+}
+
+/*
+ * Prints (fprintf) the performance of an external sort.
+ */
+void fprint_external_sort_info(FILE *file, ExternalSortInfo *info)
+{
+    fprintf(file, "\t< SIZE: %zu (%.0e)  |  TIME: %.8lfs  |  COMPARISONS: %lld  |  SWAPS: %lld >\n",
+            info->num_elements, (double) info->num_elements, info->time, info->comparisons_count, info->swaps_count);
+    fprintf(file, "\t\tRUN GENERATION: %.8lfs  |  MERGE: %.8lfs  |  RUN LENGTH: %zu  |  RUNS: %d  |  PASSES: %d  |  BYTES READ: %lld  |  BYTES WRITTEN: %lld\n",
+            info->run_generation_time, info->merge_time, info->run_length, info->num_runs, info->num_passes, info->bytes_read, info->bytes_written);
+}
@@ -0,0 +1,35 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef EXTERNAL_SORT_H
+    #define EXTERNAL_SORT_H
+    #include <stdbool.h>
+    #include <stddef.h>
+    #include <stdio.h>
+    #include "sorting_algorithms.h"
+
+    /*
+     * Performance of an external sort: wall clock time of each phase, comparisons and swaps (made by the in-memory sorts of the runs and by the merges), I/O volume, length of the runs sorted in memory and number of passes over the data (the run generation plus each merge pass).
+     */
+    typedef struct ExternalSortInfo ExternalSortInfo;
+    double get_external_time(ExternalSortInfo *info);
+    double get_external_run_generation_time(ExternalSortInfo *info);
+    double get_external_merge_time(ExternalSortInfo *info);
+    long long int get_external_comparisons_count(ExternalSortInfo *info);
+    long long int get_external_swaps_count(ExternalSortInfo *info);
+    long long int get_external_bytes_read(ExternalSortInfo *info);
+    long long int get_external_bytes_written(ExternalSortInfo *info);
+    size_t get_external_num_elements(ExternalSortInfo *info);
+    size_t get_external_run_length(ExternalSortInfo *info);
+    int get_external_num_runs(ExternalSortInfo *info);
+    int get_external_num_passes(ExternalSortInfo *info);
+    void free_external_sort_info(ExternalSortInfo *info);
+
+    ExternalSortInfo* external_sort(const char *input_path, const char *output_path, const char *temp_dir, size_t memory_bytes, int fan_in, bool in_place, SortingInfo* (*sort)(int *array, size_t size),
+                                    SortingInfo* (*count_sort)(int *array, size_t size));
+    bool generate_random_file(const char *path, size_t size);
+    bool is_file_sorted(const char *path);
+    void fprint_external_sort_info(FILE *file, ExternalSortInfo *info);
+#endif
@@ -0,0 +1,337 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include "generators.h"
+#include "sorting_algorithms.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define GENERATOR_CHUNK (1 << 20) //elements filled at a time by each generator thread
+
+static bool seed_set = false; //set to true when the seed of the generators has been chosen
+static unsigned int random_seed; //seed of the generators (valid if seed_set is true)
+static uint64_t seed_key; //64-bit key derived from the seed, mixed into every random value
+static atomic_uint seed_version; //incremented whenever the seed changes, so that the threads reseed their sequential generators
+static atomic_uint next_thread_id; //distinct id of each thread that draws sequential random numbers
+static pthread_once_t seed_once = PTHREAD_ONCE_INIT;
+
+static int almost_sorted_k = 10; //k of the almost sorted arrays generated for the ALMOST_SORTED case
+static size_t random_swaps = 0; //swaps made in the arrays of the RANDOM_SWAPS case (0 = 1% of the size)
+static int generator_threads = 0; //number of threads that fill the arrays (0 = all the cores)
+
+/*
+ * Array cases, in the order in which they're run and saved. The id labels the case in the results files.
+ */
+static const struct {
+    char *id, *name;
+} CASES[NUM_CASES] = {
+    {"random", "RANDOM ARRAYS"},
+    {"almost_sorted", "ALMOST SORTED ARRAYS"},
+    {"inversely_sorted", "INVERSELY SORTED ARRAYS"},
+    {"sorted", "SORTED ARRAYS"},
+    {"few_unique", "FEW UNIQUE VALUES ARRAYS"},
+    {"zipf", "ZIPF DISTRIBUTED ARRAYS"},
+    {"organ_pipe", "ORGAN PIPE ARRAYS"},
+    {"sawtooth", "SAWTOOTH ARRAYS"},
+    {"gaussian", "GAUSSIAN DISTRIBUTED ARRAYS"},
+    {"random_swaps", "SORTED ARRAYS WITH RANDOM SWAPS"}
+};
+
+// getters and setters of the array cases
+const char* get_case_id(int array_case) {return CASES[array_case].id;}
+const char* get_case_name(int array_case) {return CASES[array_case].name;}
+void set_almost_sorted_k(int k) {almost_sorted_k = k;}
+int get_almost_sorted_k(void) {return almost_sorted_k;}
+
+/*
+ * Sets the number of swaps made in the arrays of the RANDOM_SWAPS case. If it's 0, 1% of the size of each array (at least 1) is used.
+ */
+void set_random_swaps(size_t k) {random_swaps = k;}
+
+size_t get_random_swaps(size_t size) {
+    if(random_swaps > 0)
+        return random_swaps;
+    return (size / 100 > 0) ? size / 100 : 1;
+}
+
+/*
+ * Sets the number of threads that fill the generated arrays. If it's lower than 1, all the cores are used. The arrays don't depend on it.
+ */
+void set_generator_threads(int num_threads) {generator_threads = num_threads;}
+
+/*
+ * SplitMix64's output function: a bijective mix of the 64 bits of x. Applied to consecutive multiples of the golden ratio, it's a fast and well tested counter-based generator.
+ */
+static inline uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/*
+ * Sets the seed of the generators, so that the same inputs can be reproduced on later runs.
+ * Not thread-safe: must be called before any array is generated.
+ */
+void set_random_seed(unsigned int seed) {
+    random_seed = seed;
+    seed_key = splitmix64(seed);
+    seed_set = true;
+    atomic_fetch_add(&seed_version, 1);
+}
+
+static void seed_from_time(void)
+{
+    if(!seed_set)
+        set_random_seed(time(NULL));
+}
+
+/*
+ * Returns the seed of the generators (chosen from the current time if it wasn't set yet).
+ */
+unsigned int get_random_seed(void) {
+    pthread_once(&seed_once, &seed_from_time);
+    return random_seed;
+}
+
+/*
+ * Counter-based generator: returns the random number at the position "index" of the sequence "stream". It only depends on the seed and on its arguments, so any part of a sequence can be computed by any thread, in any order.
+ */
+uint64_t random_value(uint64_t stream, uint64_t index)
+{
+    pthread_once(&seed_once, &seed_from_time);
+    return splitmix64(splitmix64(seed_key ^ stream) + index * 0x9E3779B97F4A7C15ull);
+}
+
+/*
+ * Sequential generator of each thread (xoshiro256**), used where the numbers are consumed one by one, like the pivots of quicksort. Each thread gets its own state, derived from the seed and from a thread id, so the threads never share (nor lock) a generator.
+ */
+static _Thread_local struct {
+    uint64_t s[4];
+    unsigned int version; //version of the seed used to seed the state (0 = not seeded)
+} thread_generator;
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/*
+ * Returns the next number of the sequential generator of the calling thread.
+ */
+uint64_t next_random(void)
+{
+    pthread_once(&seed_once, &seed_from_time);
+    unsigned int version = atomic_load(&seed_version);
+    if(thread_generator.version != version) {
+        uint64_t thread_id = atomic_fetch_add(&next_thread_id, 1);
+        for(int i = 0; i < 4; i++)
+            thread_generator.s[i] = random_value(UINT64_MAX - thread_id, i);
+        thread_generator.version = version;
+    }
+
+    uint64_t *s = thread_generator.s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9, t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+/*
+ * Maps a 64-bit random number to [0, n - 1] with a multiplication instead of a modulo (Lemire's method). The bias is below n / 2^64.
+ */
+static inline size_t scale_below(uint64_t x, size_t n) {
+    return (size_t) (((unsigned __int128) x * n) >> 64);
+}
+
+/*
+ * Returns a random number within the range [0, n - 1], for any n > 0, from the sequential generator of the calling thread.
+ */
+size_t random_below(size_t n) {
+    return scale_below(next_random(), n);
+}
+
+/*
+ * Returns a random double within [0, 1) out of a 64-bit random number.
+ */
+static inline double unit_interval(uint64_t x) {
+    return (x >> 11) * 0x1.0p-53;
+}
+
+/*
+ * Returns the greatest value generated for the given case and size (the int generators scale the values down to [0, INT_MAX] if it doesn't fit into an int).
+ */
+size_t get_case_max_value(int array_case, size_t size)
+{
+    if(array_case == FEW_UNIQUE_CASE)
+        return FEW_UNIQUE_VALUES - 1;
+    if(array_case == ALMOST_SORTED_CASE)
+        return size - 1 + almost_sorted_k;
+    return (size > 0) ? size - 1 : 0;
+}
+
+/*
+ * Stream of random_value used by the given sample (the n-th array generated with the same case and size) of a case. Each sample of each case gets its own stream, so the samples differ from each other.
+ */
+static inline uint64_t case_stream(int array_case, int sample) {
+    return ((uint64_t) sample << 8) | (uint64_t) (array_case + 1);
+}
+
+/*
+ * Returns the parameter that the arrays of the given case and size depend on, besides the seed: the k of the ALMOST_SORTED and RANDOM_SWAPS cases (0 for the other cases).
+ */
+uint64_t get_case_parameter(int array_case, size_t size)
+{
+    if(array_case == ALMOST_SORTED_CASE)
+        return almost_sorted_k;
+    if(array_case == RANDOM_SWAPS_CASE)
+        return get_random_swaps(size);
+    return 0;
+}
+
+/*
+ * Writes the values of the elements first to first + count - 1 of the given sample of an array of the given case and size to "values" (see the description of each case in generators.h). The random values of each case and sample come from a different stream of random_value.
+ */
+void generate_values(int array_case, size_t size, int sample, size_t first, size_t count, size_t *values)
+{
+    uint64_t stream = case_stream(array_case, sample);
+    switch(array_case) {
+        case RANDOM_CASE:
+            for(size_t j = 0; j < count; j++)
+                values[j] = scale_below(random_value(stream, first + j), size);
+            break;
+
+        case ALMOST_SORTED_CASE:
+            for(size_t j = 0; j < count; j++)
+                values[j] = first + j + scale_below(random_value(stream, first + j), almost_sorted_k + 1);
+            break;
+
+        case INVERSELY_SORTED_CASE:
+            for(size_t j = 0; j < count; j++)
+                values[j] = size - 1 - (first + j);
+            break;
+
+        case FEW_UNIQUE_CASE:
+            for(size_t j = 0; j < count; j++)
+                values[j] = scale_below(random_value(stream, first + j), FEW_UNIQUE_VALUES);
+            break;
+
+        case ZIPF_CASE: {
+            //inverse of the CDF of the continuous approximation of Zipf's law with exponent 1 on [1, size + 1)
+            double log_range = log((double) size + 1);
+            for(size_t j = 0; j < count; j++) {
+                size_t rank = (size_t) exp(unit_interval(random_value(stream, first + j)) * log_range);
+                values[j] = (rank > size) ? size - 1 : rank - 1;
+            }
+            break;
+        }
+
+        case ORGAN_PIPE_CASE:
+            for(size_t j = 0; j < count; j++) {
+                size_t i = first + j;
+                values[j] = (i < size - 1 - i) ? i : size - 1 - i;
+            }
+            break;
+
+        case SAWTOOTH_CASE: {
+            size_t period = (size + SAWTOOTH_TEETH - 1) / SAWTOOTH_TEETH;
+            for(size_t j = 0; j < count; j++)
+                values[j] = (first + j) % period;
+            break;
+        }
+
+        case GAUSSIAN_CASE: {
+            //Box-Muller transform of two uniform numbers
+            double mean = size / 2.0, deviation = size / 8.0;
+            for(size_t j = 0; j < count; j++) {
+                double u1 = 1 - unit_interval(random_value(stream, 2*(first + j))), u2 = unit_interval(random_value(stream, 2*(first + j) + 1));
+                double v = mean + deviation * sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+                values[j] = (v < 0) ? 0 : (v >= size - 1 ? size - 1 : (size_t) v);
+            }
+            break;
+        }
+
+        default: //SORTED_CASE and RANDOM_SWAPS_CASE (whose swaps are made afterwards)
+            for(size_t j = 0; j < count; j++)
+                values[j] = first + j;
+    }
+}
+
+/*
+ * Chunks of an array filled by a pool of generator threads.
+ */
+typedef struct {
+    void *array;
+    size_t size;
+    int array_case, sample;
+    void (*fill)(void *array, int array_case, size_t size, int sample, size_t first, size_t count);
+    atomic_size_t next_chunk;
+} FillJob;
+
+static void* fill_worker(void *arg)
+{
+    FillJob *job = arg;
+    size_t c;
+    while((c = atomic_fetch_add(&job->next_chunk, 1)) * GENERATOR_CHUNK < job->size) {
+        size_t first = c * GENERATOR_CHUNK;
+        job->fill(job->array, job->array_case, job->size, job->sample, first, (job->size - first < GENERATOR_CHUNK) ? job->size - first : GENERATOR_CHUNK);
+    }
+    return NULL;
+}
+
+/*
+ * Swaps k pairs of elements of "elem_size" bytes at random positions (the k of the RANDOM_SWAPS case). The positions come from a counter-based stream, so they don't depend on the thread that makes the swaps.
+ */
+static void apply_random_swaps(char *array, size_t elem_size, size_t size, int sample)
+{
+    char temp[64];
+    assert(elem_size <= sizeof(temp));
+
+    size_t k = get_random_swaps(size);
+    uint64_t stream = case_stream(RANDOM_SWAPS_CASE, sample);
+    for(size_t j = 0; j < k; j++) {
+        size_t a = scale_below(random_value(stream, 2*j), size), b = scale_below(random_value(stream, 2*j + 1), size);
+        memcpy(temp, array + a*elem_size, elem_size);
+        memcpy(array + a*elem_size, array + b*elem_size, elem_size);
+        memcpy(array + b*elem_size, temp, elem_size);
+    }
+}
+
+/*
+ * Fills the given sample of an array of the given case with "fill", which converts the values of the elements first to first + count - 1 (see generate_values) to the element type. The array is split into chunks of GENERATOR_CHUNK elements, filled by set_generator_threads threads; since the values depend only on the indices, the array is the same for any number of threads.
+ */
+void fill_array(void *array, size_t elem_size, size_t size, int array_case, int sample,
+                void (*fill)(void *array, int array_case, size_t size, int sample, size_t first, size_t count))
+{
+    pthread_once(&seed_once, &seed_from_time);
+    FillJob job = {.array = array, .size = size, .array_case = array_case, .sample = sample, .fill = fill};
+    atomic_init(&job.next_chunk, 0);
+
+    int num_threads = (generator_threads < 1) ? get_num_cores() : generator_threads;
+    size_t num_chunks = (size + GENERATOR_CHUNK - 1) / GENERATOR_CHUNK;
+    if((size_t) num_threads > num_chunks)
+        num_threads = (num_chunks > 0) ? num_chunks : 1;
+
+    pthread_t *threads = malloc(num_threads * sizeof(pthread_t));  assert(threads != NULL);
+    for(int t = 1; t < num_threads; t++) {
+        int error = pthread_create(&threads[t], NULL, &fill_worker, &job);  assert(error == 0);
+    }
+    fill_worker(&job);
+    for(int t = 1; t < num_threads; t++)
+        pthread_join(threads[t], NULL);
+    free(threads);
+
+    if(array_case == RANDOM_SWAPS_CASE && size > 1)
+        apply_random_swaps(array, elem_size, size, sample);
+}
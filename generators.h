@@ -0,0 +1,65 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef GENERATORS_H
+    #define GENERATORS_H
+    #include <stdbool.h>
+    #include <stddef.h>
+    #include <stdint.h>
+
+    /*
+     * Array cases (input distributions). The value of each element is a function of the seed, the case and its index only, so the arrays can be generated in parallel and are the same for any number of threads:
+     *  - random: uniform within [0, size - 1];
+     *  - almost sorted: each element at most k positions away from its sorted position (see set_almost_sorted_k);
+     *  - inversely sorted and sorted;
+     *  - few unique: uniform, with only FEW_UNIQUE_VALUES distinct values;
+     *  - zipf: Zipf-distributed values with exponent 1 (the value v + 1 is about twice as frequent as 2v + 2), so a few small values dominate;
+     *  - organ pipe: ascending up to the middle, then descending;
+     *  - sawtooth: SAWTOOTH_TEETH ascending runs;
+     *  - gaussian: normally distributed around size/2, with a standard deviation of size/8 (clamped to [0, size - 1]);
+     *  - random swaps: sorted, then k pairs of elements at random positions are swapped (see set_random_swaps).
+     */
+    #define NUM_CASES 10
+    #define RANDOM_CASE 0
+    #define ALMOST_SORTED_CASE 1
+    #define INVERSELY_SORTED_CASE 2
+    #define SORTED_CASE 3
+    #define FEW_UNIQUE_CASE 4
+    #define ZIPF_CASE 5
+    #define ORGAN_PIPE_CASE 6
+    #define SAWTOOTH_CASE 7
+    #define GAUSSIAN_CASE 8
+    #define RANDOM_SWAPS_CASE 9
+
+    #define FEW_UNIQUE_VALUES 16
+    #define SAWTOOTH_TEETH 16
+
+    const char* get_case_id(int array_case);
+    const char* get_case_name(int array_case);
+    void set_almost_sorted_k(int k);
+    int get_almost_sorted_k(void);
+    void set_random_swaps(size_t k);
+    size_t get_random_swaps(size_t size);
+
+    //seed of the generators (chosen from the current time if it isn't set)
+    void set_random_seed(unsigned int seed);
+    unsigned int get_random_seed(void);
+
+    uint64_t random_value(uint64_t stream, uint64_t index);
+    uint64_t next_random(void);
+    size_t random_below(size_t n);
+
+    void set_generator_threads(int num_threads);
+    /*
+     * The arrays of a case and size are numbered by their sample (0, 1, ...): each execution of a benchmark sorts a different sample. An array only depends on GENERATOR_VERSION, the seed, the case, the size, the sample and the case's parameter (see get_case_parameter).
+     */
+    #define GENERATOR_VERSION 1 //must be incremented whenever the values generated for a case change
+
+    size_t get_case_max_value(int array_case, size_t size);
+    uint64_t get_case_parameter(int array_case, size_t size);
+    void generate_values(int array_case, size_t size, int sample, size_t first, size_t count, size_t *values);
+    void fill_array(void *array, size_t elem_size, size_t size, int array_case, int sample,
+                    void (*fill)(void *array, int array_case, size_t size, int sample, size_t first, size_t count));
+#endif
@@ -9,11 +9,20 @@
 #include <time.h>
 #include <math.h>
 #include <string.h>
+#include <limits.h>
 #include "sorting_algorithms.h"
+#include "batch_mode.h"
+#include "results_writer.h"
+#include "sorting_networks.h"
+#include "dataset_cache.h"
+#include "plugins.h"
+#include "complexity.h"
 
 #define MIN_ARRAY_LEN_EXP 2 //minimum expoent of the size of the generated arrays (minimum k for a size of 10^k)
 #define MAX_ARRAY_LEN_EXP 6 //maximum expoent of the size of the generated arrays (maximum k for a size of 10^k)
 #define ALMOST_SORTED_ARRAY_K 10 //elements in no more than k positions from their correct sorted position
+#define DATASET_CACHE_DIR "./datasets" //where the arrays of a chosen seed are cached
+static const StatisticsConfig SPEEDUP_STATISTICS = {.warmup_runs = 2, .min_runs = 5, .max_runs = 30, .target_relative_error = 0.02}; //used by the quicksort speedup report
 const bool USE_SCREEN_CLEANER = true; //set it to false in case of incompatibility
 
 /* 
@@ -29,73 +38,166 @@ void clean_screen() {
 /*
  * Prints all the elements an array in a single line.
  */
-void print_array(int *a, int size) {
-    for(int i = 0; i < size; i++)
+void print_array(int *a, size_t size) {
+    for(size_t i = 0; i < size; i++)
         printf("%d ", a[i]);
     printf("\n");
 }
 
 /*
- * Write the current date and time to the given .txt file.
+ * Asks the user whether the statistics mode should be used and, if so, for its settings.
+ * Returns "config" if the statistics mode was chosen and NULL otherwise.
  */
-void time_now_to_file(FILE *file) {
-    time_t raw_time; time(&raw_time);
-    struct tm time_info = *localtime(&raw_time);
-    fprintf(file, "Date and time of execution: %d/%d/%d %d:%d:%d\n", time_info.tm_year + 1900, time_info.tm_mon + 1, time_info.tm_mday, time_info.tm_hour, time_info.tm_min, time_info.tm_sec);
+StatisticsConfig* read_statistics_config(StatisticsConfig *config)
+{
+    char opt = '\0';
+    printf("\nUse the statistics mode (warmup runs and repetitions until a target relative error is reached)? (y/n)\n");
+    while(scanf(" %c", &opt) == 1 && opt != 'y' && opt != 'n');
+    if(opt != 'y')
+        return NULL;
+
+    printf("\nEnter the number of warmup runs (not measured) per array:\n");
+    while(scanf(" %d", &config->warmup_runs) == 0 || config->warmup_runs < 0);
+
+    printf("\nEnter the minimum number of measured runs per array (at least 2):\n");
+    while(scanf(" %d", &config->min_runs) == 0 || config->min_runs < 2);
+
+    printf("\nEnter the maximum number of measured runs per array (0 = no limit):\n");
+    while(scanf(" %d", &config->max_runs) == 0 || config->max_runs < 0 || (config->max_runs > 0 && config->max_runs < config->min_runs));
+
+    printf("\nEnter the target relative error of the mean time, in %% (e.g. 1 for +-1%% with 95%% confidence):\n");
+    while(scanf(" %lf", &config->target_relative_error) == 0 || config->target_relative_error <= 0);
+    config->target_relative_error /= 100;
+
+    return config;
 }
 
 /*
- * Wrapper for the almost_sorted_array function.
+ * Asks the user for the element type of the arrays, among the ones the given algorithm can sort. Returns its index (see sorting_algorithms.h).
  */
-int* almost_sorted_array_aux(int size) {
-    return almost_sorted_array(size, ALMOST_SORTED_ARRAY_K);
-} 
+int read_element_type(int algorithm)
+{
+    printf("\nSelect the element type of the arrays:\n");
+    for(int t = 0; t < NUM_ELEMENT_TYPES; t++) {
+        if(is_algorithm_available(t, algorithm))
+            printf("\t%d - %s\n", t + 1, get_element_type_name(t));
+    }
+
+    int type;
+    while(scanf(" %d", &type) == 0 || type < 1 || type > NUM_ELEMENT_TYPES || !is_algorithm_available(type - 1, algorithm));
+    return type - 1;
+}
 
 /*
- * Handles the execution and analysis of a single sorting algorithm.
+ * Handles the execution and analysis of a single sorting algorithm (given by its index in the algorithms registry).
  */
-void single_algorithm_menu(SortingInfo* (*sort)(int *array, int size), const char* save_file_path, const char* name)
+void single_algorithm_menu(int algorithm)
 {
+    const char *id = get_algorithm_id(algorithm), *name = get_algorithm_name(algorithm);
     printf("You have selected %s!\n", name);
 
+    //the algorithms built for (or plugins supporting) other element types can sort any of them
+    int type = INT_ELEMENTS;
+    for(int t = 0; t < NUM_ELEMENT_TYPES; t++) {
+        if(t != INT_ELEMENTS && is_algorithm_available(t, algorithm)) {
+            type = read_element_type(algorithm);
+            break;
+        }
+    }
+
+    char save_file_path[256];
+    if(type == INT_ELEMENTS)
+        snprintf(save_file_path, sizeof(save_file_path), "./results/%s.txt", id);
+    else
+        snprintf(save_file_path, sizeof(save_file_path), "./results/%s_%s.txt", id, get_element_type_id(type));
+
+    if(strcmp(id, "parallel_quicksort") == 0) {
+        printf("\nEnter the number of threads (0 = all the %d cores):\n", get_num_cores());
+        int num_threads;
+        while(scanf(" %d", &num_threads) == 0 || num_threads < 0);
+        set_parallel_quicksort_threads(num_threads);
+    }
+
+    if(strcmp(id, "shellsort") == 0) {
+        printf("\nSelect the gap sequence:\n 0 - Ciura's (extended)\n 1 - Tokuda's\n 2 - Sedgewick's\n 3 - Pratt's\n");
+        int sequence, num_threads;
+        while(scanf(" %d", &sequence) == 0 || sequence < 0 || sequence >= NUM_GAP_SEQUENCES);
+        set_shellsort_gaps(sequence);
+        printf("\nEnter the number of threads sharing the h-sorts of the large gaps (0 = all the %d cores):\n", get_num_cores());
+        while(scanf(" %d", &num_threads) == 0 || num_threads < 0);
+        set_shellsort_threads(num_threads);
+    }
+
+    if(strcmp(id, "heapsort") == 0) {
+        HeapVariant heap;
+        int bottom_up, prefetch;
+        printf("\nEnter the arity of the heap (2, 4 or 8):\n");
+        while(scanf(" %d", &heap.arity) == 0 || (heap.arity != 2 && heap.arity != 4 && heap.arity != 8));
+        printf("\nSift the elements bottom-up (Floyd's method)? (0 - no, 1 - yes)\n");
+        while(scanf(" %d", &bottom_up) == 0 || bottom_up < 0 || bottom_up > 1);
+        printf("\nPrefetch the grandchildren of the visited nodes? (0 - no, 1 - yes)\n");
+        while(scanf(" %d", &prefetch) == 0 || prefetch < 0 || prefetch > 1);
+        heap.bottom_up = bottom_up;
+        heap.prefetch = prefetch;
+        set_heap_variant(heap);
+    }
+
+    if(!is_plugin_algorithm(algorithm) && strstr(id, "quicksort") != NULL) {
+        printf("\nSelect the partitioning method:\n 0 - Hoare's\n 1 - Block partitioning (BlockQuicksort, branch-free)\n 2 - Branchless Lomuto\n");
+        int partition;
+        while(scanf(" %d", &partition) == 0 || partition < 0 || partition >= NUM_PARTITIONS);
+        set_quicksort_partition(partition);
+    }
+
+    if(!is_plugin_algorithm(algorithm) && strstr(id, "network") != NULL) {
+        printf("\nEnter the size of the sub-arrays sorted by the sorting networks (2 - %d; instruction set: %s):\n", SORTING_NETWORK_MAX, get_network_isa_id(get_sorting_network_isa()));
+        int leaf_size;
+        while(scanf(" %d", &leaf_size) == 0 || leaf_size < 2 || leaf_size > SORTING_NETWORK_MAX);
+        set_network_leaf_size(leaf_size);
+    }
+
     //getting info from the user
-    printf("\nEnter the size of the arrays that are going to be generated (max 2*10^9):\n");
-    int size; 
-    while(scanf(" %d", &size) == 0 || size < 1);
+    printf("\nEnter the size of the arrays that are going to be generated (at least 1; sizes beyond 2^31 need 4 bytes of memory per element for each array):\n");
+    size_t size; 
+    while(scanf(" %zu", &size) == 0 || size < 1);
 
-    printf("\nEnter the number of times the sorting should be performed on each array case (1 - 10):\n");
+    printf("\nEnter the number of arrays that are going to be generated for each array case (at least 1):\n");
     int num_executions; 
-    while(scanf(" %d", &num_executions) == 0 || num_executions < 1 || num_executions > 10);
+    while(scanf(" %d", &num_executions) == 0 || num_executions < 1);
+
+    StatisticsConfig stats_config;
+    StatisticsConfig *config = read_statistics_config(&stats_config);
 
     printf("\nSorting... this might take some time!\n");
 
-    //running the algorithm
-    SortingInfo *rand_info = analyze_sorting_algorithm(sort, &random_array, size, num_executions); //randomly generated array
-    SortingInfo *semi_info = analyze_sorting_algorithm(sort, &almost_sorted_array_aux, size, num_executions); //semi-sorted array
-    SortingInfo *inv_info = analyze_sorting_algorithm(sort, &inversely_sorted_array, size, num_executions); //inversely sorted array
-    SortingInfo *sorted_info = analyze_sorting_algorithm(sort, &sorted_array, size, num_executions); //sorted array
+    //running the algorithm on each array case (see generators.h)
+    SortingInfo *infos[NUM_CASES];
+    for(int i = 0; i < NUM_CASES; i++)
+        infos[i] = analyze_sorting_algorithm(type, algorithm, i, size, num_executions, config);
 
     //printing results
     clean_screen();
     printf("Finished sorting with %s!\n" 
-            "Size of the arrays: %d  |  Number of executions per array case: %d\n\n", name, size, num_executions);
-    printf("[RANDOM ARRAYS]  Time: %.7lfs  |  Comparisons: %lld  |  Swaps: %lld\n", 
-            get_execution_time(rand_info), get_comparisons_count(rand_info), get_swaps_count(rand_info));
-    printf("[ALMOST SORTED ARRAYS]  Time: %.7lfs  |  Comparisons: %lld  |  Swaps: %lld\n", 
-            get_execution_time(semi_info), get_comparisons_count(semi_info), get_swaps_count(semi_info));
-    printf("[INVERSELY SORTED ARRAYS]  Time: %.7lfs  |  Comparisons: %lld  |  Swaps: %lld\n", 
-            get_execution_time(inv_info), get_comparisons_count(inv_info), get_swaps_count(inv_info));
-    printf("[SORTED ARRAYS]  Time: %.7lfs  |  Comparisons: %lld  |  Swaps: %lld\n", 
-            get_execution_time(sorted_info), get_comparisons_count(sorted_info), get_swaps_count(sorted_info));
+            "Element type: %s  |  Size of the arrays: %zu  |  Number of executions per array case: %d\n\n", name, get_element_type_name(type), size, num_executions);
+    for(int i = 0; i < NUM_CASES; i++) {
+        printf("[%s]  Time: %.7lfs  |  Instrumented time: %.7lfs  |  Comparisons: %lld  |  Swaps: %lld\n\t", 
+                get_case_name(i), get_execution_time(infos[i]), get_instrumented_time(infos[i]), get_comparisons_count(infos[i]), get_swaps_count(infos[i]));
+        fprint_hw_counters(stdout, infos[i]);
+        printf("\n\t");
+        fprint_time_statistics(stdout, infos[i]);
+        printf("\n");
+    }
 
     //saving results
     FILE *file = fopen(save_file_path, "w");  assert(file != NULL);
     time_now_to_file(file);
-    save_sorting_info(rand_info, semi_info, inv_info, sorted_info, size, num_executions, file);
+    fprintf(file, "Element type: %s\n", get_element_type_name(type));
+    save_sorting_info(infos, size, num_executions, file);
     fclose(file);
 
     //freeing memory
-    free(rand_info);  free(semi_info);  free(inv_info);  free(sorted_info);
+    for(int i = 0; i < NUM_CASES; i++)
+        free_sorting_info(infos[i]);
 
     //exit
     char opt;
@@ -104,16 +206,62 @@ void single_algorithm_menu(SortingInfo* (*sort)(int *array, int size), const cha
 }
 
 /*
- * Print to a file (fprintf) the performance of an algorithm on all the array sizes for a given case.
+ * Sorts the same random arrays with quicksort and parallel_quicksort, with sizes going from 10^2 to 10^10 (the sizes that don't fit into memory are skipped), and reports the speedup of the parallel version at each size.
+ * Both are measured in the statistics mode (see StatisticsConfig), with SPEEDUP_STATISTICS, and the speedup is the ratio of their median times, so a single noisy run can't skew it.
  */
-void fprint_case(FILE *file, SortingInfo **info, int min_size, int max_size) 
+void quicksort_speedup_report()
 {
-    int num_sizes = max_size - min_size + 1;
-    for(int j = 0; j < num_sizes; j++) {
-        int k = (j + MIN_ARRAY_LEN_EXP);
-        fprintf(file, "\t< SIZE: %d (10^%d)  |  TIME: %.8lfs  |  COMPARISONS: %lld  |  SWAPS: %lld >\n", 
-            (int)pow(10, k), k, get_execution_time(info[j]), get_comparisons_count(info[j]), get_swaps_count(info[j]));
+    printf("< Parallel Quicksort speedup report >\n\n");
+    printf("Enter the number of threads (0 = all the %d cores):\n", get_num_cores());
+    int num_threads;
+    while(scanf(" %d", &num_threads) == 0 || num_threads < 0);
+    set_parallel_quicksort_threads(num_threads);
+
+    const char *save_file_path = "./results/parallel_quicksort_speedup.txt";
+    FILE *file = fopen(save_file_path, "w");  assert(file != NULL);
+    time_now_to_file(file);
+    fprintf(file, "Number of threads: %d\n", (num_threads < 1) ? get_num_cores() : num_threads);
+    fprintf(file, "Statistics mode: %d warmup runs, %d to %d measured runs, target relative error of %.2lf%%\n\n",
+            SPEEDUP_STATISTICS.warmup_runs, SPEEDUP_STATISTICS.min_runs, SPEEDUP_STATISTICS.max_runs, 100 * SPEEDUP_STATISTICS.target_relative_error);
+
+    int serial = find_algorithm("quicksort"), parallel = find_algorithm("parallel_quicksort");
+    assert(serial >= 0 && parallel >= 0);
+    printf("\nSorting random arrays... this might take some time!\n\n");
+    for(int k = 2; k <= 10; k++) {
+        size_t size = (size_t) pow(10, k);
+        int *array = random_array(size), 
+            *temp_array = (array != NULL) ? malloc(size * sizeof(int)) : NULL;
+
+        if(array == NULL || temp_array == NULL) {
+            printf("\t< SIZE: 10^%d  |  not enough memory, skipping >\n", k);
+            fprintf(file, "\t< SIZE: %zu (10^%d)  |  NOT ENOUGH MEMORY >\n", size, k);
+            free(array);  free(temp_array);
+            continue;
+        }
+
+        //the zero-overhead versions are compared
+        bool serial_sorted, parallel_sorted;
+        SortingInfo *serial_info = measure_sorting_algorithm(INT_ELEMENTS, serial, array, temp_array, size, &SPEEDUP_STATISTICS, &serial_sorted);
+        SortingInfo *parallel_info = measure_sorting_algorithm(INT_ELEMENTS, parallel, array, temp_array, size, &SPEEDUP_STATISTICS, &parallel_sorted);
+        assert(serial_sorted && parallel_sorted);
+
+        TimeStatistics serial_stats = get_time_statistics(serial_info), parallel_stats = get_time_statistics(parallel_info);
+        free_sorting_info(serial_info);  free_sorting_info(parallel_info);
+
+        double speedup = serial_stats.median / parallel_stats.median;
+        printf("\t< SIZE: 10^%d  |  QUICKSORT: %.8lfs  |  PARALLEL: %.8lfs  |  SPEEDUP: %.2lfx >\n", k, serial_stats.median, parallel_stats.median, speedup);
+        fprintf(file, "\t< SIZE: %zu (10^%d)  |  QUICKSORT: %.8lfs (%d runs)  |  PARALLEL QUICKSORT: %.8lfs (%d runs)  |  SPEEDUP: %.2lfx >\n",
+                size, k, serial_stats.median, serial_stats.num_samples, parallel_stats.median, parallel_stats.num_samples, speedup);
+        fflush(file);
+
+        free(array);  free(temp_array);
     }
+    fclose(file);
+
+    //exit
+    char opt;
+    printf("\nInformations saved to \"%s\". \nEnter 0 to go back to the main menu.\n", save_file_path);
+    do { scanf(" %c", &opt); } while(opt != '0');
 }
 
 /*
@@ -122,126 +270,125 @@ void fprint_case(FILE *file, SortingInfo **info, int min_size, int max_size)
 void analyze_all()
 {
     printf("< Analyzing all the sorting algorithms! >\n\n");
-    printf("Each sorting algorithm will be executed n times on n different arrays for each of the 4 arrays cases (randomly generated, almost sorted, sorted and inversely sorted) and for each pre-chosen array size. For a given array case and size, all the algorithms will be executed on the same n arrays, so that their performance can be better compared. The size of each array will be 10^k, where k goes from %d to %d.\n", MIN_ARRAY_LEN_EXP, MAX_ARRAY_LEN_EXP);
+    printf("Each sorting algorithm will be executed n times on n different arrays for each of the %d arrays cases (randomly generated, almost sorted, inversely sorted, sorted, with few unique values, Zipf distributed, organ pipe, sawtooth, Gaussian distributed and sorted with random swaps) and for each pre-chosen array size. For a given array case and size, all the algorithms will be executed on the same n arrays, so that their performance can be better compared. The size of each array will be 10^k, where k goes from %d to %d.\n", NUM_CASES, MIN_ARRAY_LEN_EXP, MAX_ARRAY_LEN_EXP);
     
     //GETTING ARRAY CASES
-    char cases_opt = '\0';
-    bool random_case = false, almost_case = false, inv_case = false, sorted_case = false;
+    int cases_opt = 0;
+    bool run_case[NUM_CASES] = {false};
     do {
-        if(cases_opt != '\0')
+        if(cases_opt != 0)
             printf("Invalid option!\n");
 
         printf("\nSelect the array generation policy.\n"
-            "\t1 - ALL CASES\n"
-            "\t2 - RANDOM ARRAYS ONLY\n"
-            "\t3 - ALMOST SORTED ARRAYS ONLY\n"
-            "\t4 - INVERSELY SORTED ARRAYS ONLY\n"
-            "\t5 - SORTED ARRAYS ONLY\n"
-            "Choose an option: ");
-    } while(scanf(" %c", &cases_opt) == 1 && 
-            (cases_opt != '1' && cases_opt != '2' && cases_opt != '3' && cases_opt != '4' && cases_opt != '5'));
-
-    switch(cases_opt) {
-        case '1':   
-            random_case = almost_case = inv_case = sorted_case = true;  break;
-        case '2':
-            random_case = true;  break;
-        case '3':
-            almost_case = true;  break;
-        case '4':
-            inv_case = true;  break;
-        case '5':
-            sorted_case = true;  break;
-    }
+            "\t1 - ALL CASES\n");
+        for(int c = 0; c < NUM_CASES; c++)
+            printf("\t%d - %s ONLY\n", c + 2, get_case_name(c));
+        printf("Choose an option: ");
+    } while(scanf(" %d", &cases_opt) == 1 && (cases_opt < 1 || cases_opt > NUM_CASES + 1));
+
+    for(int c = 0; c < NUM_CASES; c++)
+        run_case[c] = (cases_opt == 1 || cases_opt - 2 == c);
 
     //GETTING NUM OF EXECUTIONS
-    printf("\nEnter a value for n (number of executions per array case):  (1 - 10)\n");
+    printf("\nEnter a value for n (number of executions per array case, at least 1):\n");
     int num_executions; 
-    while(scanf(" %d", &num_executions) == 0 || num_executions < 1 || num_executions > 10);
+    while(scanf(" %d", &num_executions) == 0 || num_executions < 1);
+
+    StatisticsConfig stats_config;
+    StatisticsConfig *config = read_statistics_config(&stats_config);
+
+    //GETTING PARALLELISM
+    printf("\nEnter the number of worker threads that will run the sorting jobs in parallel (0 = all the %d cores):\n", get_num_cores());
+    int num_workers;
+    while(scanf(" %d", &num_workers) == 0 || num_workers < 0);
+
+    char pin_opt = '\0';
+    printf("\nPin each worker to a different core? (y/n)\n");
+    while(scanf(" %c", &pin_opt) == 1 && pin_opt != 'y' && pin_opt != 'n');
+    bool pin_workers = (pin_opt == 'y');
+
+    //GETTING THE SEED
+    printf("\nEnter the seed of the arrays (the arrays of a seed are saved to \"%s\" and loaded from there on later runs), or -1 for a random seed:\n", DATASET_CACHE_DIR);
+    long long int seed;
+    while(scanf(" %lld", &seed) == 0 || seed < -1 || seed > UINT_MAX);
+    set_random_seed((seed >= 0) ? (unsigned int) seed : (unsigned int) time(NULL));
+    if(!set_dataset_cache_dir((seed >= 0) ? DATASET_CACHE_DIR : NULL))
+        printf("WARNING: couldn't create \"%s\", the arrays won't be cached.\n", DATASET_CACHE_DIR);
+
+    //GETTING THE TIME BUDGET
+    TimeBudget budget = {0, 0, 0};
+    printf("\nEnter the max. time of each algorithm on each size, in seconds (the sizes whose predicted time exceeds it are skipped), or 0 for no limit:\n");
+    while(scanf(" %lf", &budget.cell_seconds) == 0 || budget.cell_seconds < 0);
+    printf("\nEnter the max. time of a single sort, in seconds (slower sorts are killed), or 0 for no limit:\n");
+    while(scanf(" %lf", &budget.timeout_seconds) == 0 || budget.timeout_seconds < 0);
 
     //SORTING
     clean_screen();
     printf("Sorting... this might take some time!\n\n");
-    SortingInfo ***rand_info, ***semi_info, ***inv_info, ***sorted_info;
-
-    if(random_case) {
-        printf("-> RANDOM ARRAYS:\n");
-        rand_info = analyze_case_on_all(&random_array, MIN_ARRAY_LEN_EXP, MAX_ARRAY_LEN_EXP, num_executions);
-    }
-
-    if(almost_case) {
-        printf("\n-> ALMOST SORTED ARRAYS (k = %d):\n", ALMOST_SORTED_ARRAY_K);
-        semi_info = analyze_case_on_all(&almost_sorted_array_aux, MIN_ARRAY_LEN_EXP, MAX_ARRAY_LEN_EXP, num_executions);
-    }
-
-    if(inv_case) {
-        printf("\n-> INVERSELY SORTED ARRAYS:\n");
-        inv_info = analyze_case_on_all(&inversely_sorted_array, MIN_ARRAY_LEN_EXP, MAX_ARRAY_LEN_EXP, num_executions);
-    }
-
-    if(sorted_case) {
-        printf("\n-> SORTED ARRAYS:\n");
-        sorted_info = analyze_case_on_all(&sorted_array, MIN_ARRAY_LEN_EXP, MAX_ARRAY_LEN_EXP, num_executions);
+    CaseResults *results[NUM_CASES];
+    const int num_sizes = MAX_ARRAY_LEN_EXP - MIN_ARRAY_LEN_EXP + 1;
+    size_t sizes[MAX_ARRAY_LEN_EXP - MIN_ARRAY_LEN_EXP + 1];
+    for(int k = MIN_ARRAY_LEN_EXP; k <= MAX_ARRAY_LEN_EXP; k++)
+        sizes[k - MIN_ARRAY_LEN_EXP] = (size_t) pow(10, k);
+    set_time_budget(budget);
+
+    //the records of each execution are streamed to these files as soon as they're measured
+    ResultsWriter *writer = results_writer_open("./results/results.csv", "./results/results.jsonl");  assert(writer != NULL);
+
+    for(int c = 0; c < NUM_CASES; c++) {
+        if(!run_case[c])
+            continue;
+        if(c == ALMOST_SORTED_CASE)
+            printf("\n-> %s (k = %d):\n", get_case_name(c), ALMOST_SORTED_ARRAY_K);
+        else
+            printf("\n-> %s:\n", get_case_name(c));
+        results[c] = analyze_case(INT_ELEMENTS, c, sizes, num_sizes, NULL, num_executions, num_workers, pin_workers, config, writer);
     }
 
     //SAVING
-    FILE *files[] = {fopen("./results/bubble_sort.txt", "w"), fopen("./results/flagged_bubble_sort.txt", "w"), 
-                    fopen("./results/selection_sort.txt", "w"), fopen("./results/insertion_sort.txt", "w"), 
-                    fopen("./results/heapsort.txt", "w"), fopen("./results/shellsort.txt", "w"),
-                    fopen("./results/quicksort.txt", "w"), fopen("./results/merge_sort.txt", "w")};
-
-    const int num_sizes = MAX_ARRAY_LEN_EXP - MIN_ARRAY_LEN_EXP + 1;
-
-    for(int i = 0; i < 8; i++) {
-        FILE *f = files[i];  assert(f != NULL);
+    for(int i = 0; i < get_num_algorithms(); i++) {
+        char path[256];
+        snprintf(path, sizeof(path), "./results/%s.txt", get_algorithm_id(i));
+        FILE *f = fopen(path, "w");  assert(f != NULL);
         time_now_to_file(f);
-        fprintf(f, "Number of executions per array case and size: %d\n\n", num_executions);
-
-        //random arrays
-        if(random_case) {
-            fprintf(f, "-> RANDOM ARRAYS:\n");
-            fprint_case(f, rand_info[i], MIN_ARRAY_LEN_EXP, MAX_ARRAY_LEN_EXP);
-        }
-
-        //almost sorted arrays
-        if(almost_case) {
-            fprintf(f, "\n-> ALMOST SORTED ARRAYS (k = %d):\n", ALMOST_SORTED_ARRAY_K);
-            fprint_case(f, semi_info[i], MIN_ARRAY_LEN_EXP, MAX_ARRAY_LEN_EXP);
-        }
-
-        //inversely sorted arrays
-        if(inv_case) {
-            fprintf(f, "\n-> INVERSELY SORTED ARRAYS:\n");
-            fprint_case(f, inv_info[i], MIN_ARRAY_LEN_EXP, MAX_ARRAY_LEN_EXP);
+        fprintf(f, "Number of executions per array case and size: %d\n", num_executions);
+        fprintf(f, "Seed: %u\n", get_random_seed());
+        if(config != NULL)
+            fprintf(f, "Statistics mode: %d warmup run(s)  |  min. measured runs per array: %d  |  max. measured runs per array: %d (0 = no limit)  |  target relative error: %.2lf%%\n", 
+                    config->warmup_runs, config->min_runs, config->max_runs, 100 * config->target_relative_error);
+        if(budget.cell_seconds > 0 || budget.timeout_seconds > 0)
+            fprintf(f, "Time budget: %.2lfs per cell  |  timeout: %.2lfs (0 = no limit)\n", budget.cell_seconds, budget.timeout_seconds);
+
+        for(int c = 0; c < NUM_CASES; c++) {
+            if(!run_case[c])
+                continue;
+            if(c == ALMOST_SORTED_CASE)
+                fprintf(f, "\n-> %s (k = %d):\n", get_case_name(c), ALMOST_SORTED_ARRAY_K);
+            else
+                fprintf(f, "\n-> %s:\n", get_case_name(c));
+            fprint_case(f, results[c], i, sizes);
         }
+        fclose(f);
+    }
 
-        //sorted arrays
-        if(sorted_case) {
-            fprintf(f, "\n-> SORTED ARRAYS:\n");
-            fprint_case(f, sorted_info[i], MIN_ARRAY_LEN_EXP, MAX_ARRAY_LEN_EXP);
-        }
+    FILE *f = fopen("./results/complexity.txt", "w");  assert(f != NULL);
+    time_now_to_file(f);
+    for(int c = 0; c < NUM_CASES; c++) {
+        if(!run_case[c])
+            continue;
+        fprintf(f, "\n-> %s:\n", get_case_name(c));
+        fprint_complexity_report(f, results[c], INT_ELEMENTS, sizes, num_sizes, NULL);
     }
+    fclose(f);
     
+    if(!results_writer_close(writer))
+        printf("\nWARNING: couldn't write all the records to \"./results/results.csv\" and \"./results/results.jsonl\".\n");
+
     //FREEING MEMORY
-    for(int i = 0; i < 8; i++) {
-        fclose(files[i]);
-        for(int j = 0; j < num_sizes; j++) {
-            if(random_case) free(rand_info[i][j]);  
-            if(almost_case) free(semi_info[i][j]);  
-            if(inv_case) free(inv_info[i][j]);  
-            if(sorted_case) free(sorted_info[i][j]);
-        }
-        
-        if(random_case) free(rand_info[i]);  
-        if(almost_case) free(semi_info[i]);  
-        if(inv_case) free(inv_info[i]);  
-        if(sorted_case) free(sorted_info[i]);
+    for(int c = 0; c < NUM_CASES; c++) {
+        if(run_case[c])
+            free_case_results(results[c]);
     }
-    
-    if(random_case) free(rand_info);  
-    if(almost_case) free(semi_info);  
-    if(inv_case) free(inv_info);  
-    if(sorted_case) free(sorted_info);
 
     //EXIT
     char opt;
@@ -250,77 +397,78 @@ void analyze_all()
 }
 
 /*
- * Handles the display of the main menu and its operations.
+ * Asks the user for the path of a sort plugin and loads it (see plugins.h).
  */
-void main_menu()
+void load_plugin_menu()
 {
-    const char *const MENU_TXT = 
-        "< Sorting algorithms analyzer by Talendar (Gabriel Nogueira) >\n\n"
-        "  1 - Bubble Sort\n"
-        "  2 - Flagged Bubble Sort (Bubble Sort with sentinel)\n"
-        "  3 - Selection Sort\n"
-        "  4 - Insertion Sort\n"
-        "  5 - Heapsort\n"
-        "  6 - Shellsort (using Ciura's gap sequence)\n"
-        "  7 - Quicksort (partitioning with a random pivot)\n"
-        "  8 - Merge Sort\n"
-        "  9 - ALL\n"
-        "  0 - Exit\n"
-        "\nChoose an option: ";
+    printf("< Loading a sort plugin >\n\nEnter the path of the shared object (e.g. ./example_plugin.so):\n");
+    char path[PATH_MAX];
+    while(scanf(" %4095s", path) != 1);
+
+    int added = load_sort_plugin(path);
+    if(added >= 0)
+        printf("\n%d algorithm(s) added to the menu.\n", added);
 
     char opt;
+    printf("\nEnter 0 to go back to the main menu.\n");
+    do { scanf(" %c", &opt); } while(opt != '0');
+}
+
+/*
+ * Handles the display of the main menu and its operations. The algorithms are listed in the order of the registry (see sorting_algorithms.h), including the ones loaded from plugins.
+ */
+void main_menu()
+{
+    char opt[16] = "";
     clean_screen();
 
     do {
-        printf("%s", MENU_TXT);
-        scanf(" %c", &opt);
-
-        if(opt != '0')
-            clean_screen();
-
-        switch(opt)
-        {
-            case '1':
-                single_algorithm_menu(&bubble_sort, "./results/bubble_sort.txt", "Bubble Sort");
-                break;
-            case '2':
-                single_algorithm_menu(&flagged_bubble_sort, "./results/flagged_bubble_sort.txt", "Flagged Bubble Sort (Bubble Sort with sentinel)");
-                break;
-            case '3':
-                single_algorithm_menu(&selection_sort, "./results/selection_sort.txt", "Selection Sort");
-                break;
-            case '4':
-                single_algorithm_menu(&insertion_sort, "./results/insertion_sort.txt", "Insertion Sort");
-                break;
-            case '5':
-                single_algorithm_menu(&heapsort, "./results/heapsort.txt", "Heapsort");
-                break;
-            case '6':
-                single_algorithm_menu(&shellsort, "./results/shellsort.txt", "Shellsort");
-                break;
-            case '7':
-                single_algorithm_menu(&quicksort, "./results/quicksort.txt", "Quicksort");
-                break;
-            case '8':
-                single_algorithm_menu(&merge_sort, "./results/merge_sort.txt", "Merge Sort");
-                break;
-            case '9':
-                analyze_all();
-                break;
-            case '0':
-                printf("\nLeaving...\n\n");
+        printf("< Sorting algorithms analyzer by Talendar (Gabriel Nogueira) >\n\n");
+        for(int i = 0; i < get_num_algorithms(); i++) {
+            printf("  %2d - %s  (", i + 1, get_algorithm_name(i));
+            fprint_algorithm_properties(stdout, i);
+            printf("%s)\n", is_plugin_algorithm(i) ? ", plugin" : "");
         }
+        printf("\n   s - Parallel Quicksort speedup report (10^2 - 10^10)\n"
+               "   p - Load a sort plugin (shared object)\n"
+               "   a - ALL\n"
+               "   0 - Exit\n"
+               "\nChoose an option: ");
+        if(scanf(" %15s", opt) != 1)
+            break;
+
+        if(strcmp(opt, "0") != 0)
+            clean_screen();
 
-        if(opt != '0')
+        int index = atoi(opt);
+        if(index >= 1 && index <= get_num_algorithms())
+            single_algorithm_menu(index - 1);
+        else if(strcmp(opt, "s") == 0)
+            quicksort_speedup_report();
+        else if(strcmp(opt, "p") == 0)
+            load_plugin_menu();
+        else if(strcmp(opt, "a") == 0)
+            analyze_all();
+        else if(strcmp(opt, "0") == 0)
+            printf("\nLeaving...\n\n");
+
+        if(strcmp(opt, "0") != 0)
             clean_screen();
 
-    } while(opt != '0');
+    } while(strcmp(opt, "0") != 0);
 }
 
 /*
  * MAIN
  */
-int main() {
+/*
+ * Runs the batch mode if any command line argument was given (see batch_mode.h) and the interactive menu otherwise.
+ */
+int main(int argc, char **argv) {
+    set_almost_sorted_k(ALMOST_SORTED_ARRAY_K);
+    if(argc > 1)
+        return run_batch(argc, argv);
+
     main_menu();
     return 0;
 }
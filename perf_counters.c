@@ -0,0 +1,139 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include "perf_counters.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+
+#define NUM_EVENTS 5
+
+/*
+ * Events measured, in the same order as the fields of PerfCounters.
+ */
+static const struct {
+    unsigned int type;
+    unsigned long long int config;
+} EVENTS[NUM_EVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+};
+
+//the events are counted per thread, so each thread has its own file descriptors (opened on the first measurement)
+static __thread bool events_opened = false;
+static __thread int event_fds[NUM_EVENTS];
+
+/*
+ * Returns the current time of the raw monotonic clock (not subject to NTP adjustments), in seconds.
+ */
+double monotonic_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Opens, disabled, a counter for the given event on the calling thread. The counter also counts the threads created by the calling thread after it's opened (their counts are added to it when they exit), so multithreaded sorts are fully measured.
+ * Reads of the counter also return the times it was enabled and running, since the kernel multiplexes the counters when there are more events than hardware counters (see perf_counters_stop).
+ * Returns the counter's file descriptor or -1 if the event isn't available.
+ */
+static int open_event(unsigned int type, unsigned long long int config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1; //allows measuring without privileges when perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void open_events(void)
+{
+    for(int i = 0; i < NUM_EVENTS; i++)
+        event_fds[i] = open_event(EVENTS[i].type, EVENTS[i].config);
+    events_opened = true;
+}
+
+/*
+ * Returns true if at least one of the events can be counted on the calling thread.
+ */
+bool perf_counters_available(void)
+{
+    if(!events_opened)
+        open_events();
+
+    for(int i = 0; i < NUM_EVENTS; i++) {
+        if(event_fds[i] >= 0)
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Resets and starts the counters of the calling thread.
+ */
+void perf_counters_start(void)
+{
+    if(!events_opened)
+        open_events();
+
+    for(int i = 0; i < NUM_EVENTS; i++) {
+        if(event_fds[i] >= 0) {
+            ioctl(event_fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(event_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+/*
+ * Stops the counters of the calling thread and stores their values in "counters". A counter that was multiplexed (running only part of the time it was enabled) is scaled up by time_enabled / time_running. Events that couldn't be counted, or whose counter never got to run, are set to PERF_COUNTER_UNAVAILABLE.
+ */
+void perf_counters_stop(PerfCounters *counters)
+{
+    long long int values[NUM_EVENTS];
+    for(int i = 0; i < NUM_EVENTS; i++) {
+        values[i] = PERF_COUNTER_UNAVAILABLE;
+        if(events_opened && event_fds[i] >= 0) {
+            unsigned long long int data[3]; //value, time_enabled and time_running
+            ioctl(event_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            if(read(event_fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0)
+                continue;
+            values[i] = (data[2] < data[1]) ? (long long int) ((double) data[0] * data[1] / data[2] + 0.5) : (long long int) data[0];
+        }
+    }
+
+    counters->cycles = values[0];
+    counters->instructions = values[1];
+    counters->l1_misses = values[2];
+    counters->llc_misses = values[3];
+    counters->branch_misses = values[4];
+}
+
+/*
+ * Closes the counters of the calling thread. Must be called by threads that measured something before they exit.
+ */
+void perf_counters_close(void)
+{
+    if(!events_opened)
+        return;
+
+    for(int i = 0; i < NUM_EVENTS; i++) {
+        if(event_fds[i] >= 0)
+            close(event_fds[i]);
+    }
+    events_opened = false;
+}
@@ -0,0 +1,25 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef PERF_COUNTERS_H
+    #define PERF_COUNTERS_H
+    #include <stdbool.h>
+
+    #define PERF_COUNTER_UNAVAILABLE -1LL //value of a counter that couldn't be measured
+
+    /*
+     * Hardware events counted around a measured region of code. Events that the kernel (or the hardware) doesn't support are set to PERF_COUNTER_UNAVAILABLE.
+     */
+    typedef struct {
+        long long int cycles, instructions, l1_misses, llc_misses, branch_misses;
+    } PerfCounters;
+
+    double monotonic_time(void);
+
+    bool perf_counters_available(void);
+    void perf_counters_start(void);
+    void perf_counters_stop(PerfCounters *counters);
+    void perf_counters_close(void);
+#endif
@@ -0,0 +1,63 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include "plugins.h"
+#include "sorting_algorithms.h"
+#include <stdio.h>
+#include <dlfcn.h>
+
+/*
+ * Builds the table of functions (indexed by element type) of an algorithm of a plugin. The int64_callback type is never supported: the plugins can't use its comparator.
+ */
+static void plugin_sorts(const SortPluginAlgorithm *algorithm, SortPluginFunction sorts[NUM_ELEMENT_TYPES])
+{
+    for(int t = 0; t < NUM_ELEMENT_TYPES; t++)
+        sorts[t] = NULL;
+    sorts[find_element_type("int")] = algorithm->sort_int;
+    sorts[find_element_type("int64")] = algorithm->sort_int64;
+    sorts[find_element_type("float")] = algorithm->sort_float;
+    sorts[find_element_type("double")] = algorithm->sort_double;
+    sorts[find_element_type("kv")] = algorithm->sort_kv;
+}
+
+int load_sort_plugin(const char *path)
+{
+    //RTLD_LOCAL: the symbols of different plugins don't clash
+    void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if(handle == NULL) {
+        fprintf(stderr, "Couldn't load the plugin \"%s\": %s\n", path, dlerror());
+        return -1;
+    }
+
+    SortPluginEntry entry;
+    *(void**) &entry = dlsym(handle, SORT_PLUGIN_SYMBOL); //the cast through void** avoids converting an object pointer to a function pointer
+    const SortPlugin *plugin = (entry != NULL) ? entry() : NULL;
+    if(plugin == NULL) {
+        fprintf(stderr, "\"%s\" isn't a sort plugin (no \"%s\" function, or it returned NULL)!\n", path, SORT_PLUGIN_SYMBOL);
+        dlclose(handle);
+        return -1;
+    }
+    if(plugin->abi_version != SORT_PLUGIN_ABI_VERSION) {
+        fprintf(stderr, "The plugin \"%s\" was built for version %d of the plugin ABI, but this program uses version %d!\n", path, plugin->abi_version, SORT_PLUGIN_ABI_VERSION);
+        dlclose(handle);
+        return -1;
+    }
+
+    //the registry points to the strings and functions of the plugin, so it's only unloaded if none of its algorithms was added
+    int added = 0;
+    for(int i = 0; i < plugin->num_algorithms; i++) {
+        const SortPluginAlgorithm *algorithm = &plugin->algorithms[i];
+        SortPluginFunction sorts[NUM_ELEMENT_TYPES];
+        plugin_sorts(algorithm, sorts);
+        if(register_algorithm(algorithm->id, algorithm->name, algorithm->properties, sorts) < 0)
+            fprintf(stderr, "WARNING: skipping the algorithm \"%s\" of the plugin \"%s\" (the registry is full, its id is invalid or already taken, or it doesn't sort ints).\n",
+                    (algorithm->id != NULL) ? algorithm->id : "(null)", path);
+        else
+            added++;
+    }
+    if(added == 0)
+        dlclose(handle);
+    return added;
+}
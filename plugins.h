@@ -0,0 +1,14 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef PLUGINS_H
+    #define PLUGINS_H
+
+    /*
+     * Loads a sort plugin (a shared object implementing the ABI of sort_plugin.h) and adds its algorithms to the registry of sorting_algorithms.h, after the built-in ones.
+     * Returns the number of algorithms added, or -1 if the plugin couldn't be loaded (the reason is printed to stderr).
+     */
+    int load_sort_plugin(const char *path);
+#endif
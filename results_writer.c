@@ -0,0 +1,211 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include "results_writer.h"
+#include "perf_counters.h"
+
+#ifndef BUILD_FLAGS
+    #define BUILD_FLAGS "unknown" //set by the makefile
+#endif
+
+#define CPU_MODEL_LEN 256
+
+struct ResultsWriter {
+    FILE *csv, *jsonl;
+    bool failed; //set when a write fails
+    char cpu_model[CPU_MODEL_LEN];
+};
+
+static const char *CSV_HEADER = "timestamp,algorithm,element_type,case,size,repetition,seed,time,instrumented_time,comparisons,swaps,"
+                                "cycles,instructions,l1_misses,llc_misses,branch_misses,num_samples,samples,cpu_model,build_flags,compiler\n";
+
+/*
+ * Reads the model of the CPU from /proc/cpuinfo. Falls back to "unknown" if it isn't available.
+ */
+static void read_cpu_model(char *model, int len)
+{
+    snprintf(model, len, "unknown");
+    FILE *file = fopen("/proc/cpuinfo", "r");
+    if(file == NULL)
+        return;
+
+    char line[512];
+    while(fgets(line, sizeof(line), file) != NULL) {
+        if(strncmp(line, "model name", 10) == 0) {
+            char *value = strchr(line, ':');
+            if(value != NULL) {
+                value += 1 + strspn(value + 1, " \t");
+                value[strcspn(value, "\r\n")] = '\0';
+                snprintf(model, len, "%s", value);
+            }
+            break;
+        }
+    }
+    fclose(file);
+}
+
+/*
+ * Prints a string as a quoted CSV field (quotes are doubled).
+ */
+static void fprint_csv_string(FILE *file, const char *str)
+{
+    fputc('"', file);
+    for(; *str != '\0'; str++) {
+        if(*str == '"')
+            fputc('"', file);
+        fputc(*str, file);
+    }
+    fputc('"', file);
+}
+
+/*
+ * Prints a string as a JSON string literal.
+ */
+static void fprint_json_string(FILE *file, const char *str)
+{
+    fputc('"', file);
+    for(; *str != '\0'; str++) {
+        if(*str == '"' || *str == '\\')
+            fprintf(file, "\\%c", *str);
+        else if((unsigned char) *str < 0x20)
+            fprintf(file, "\\u%04x", *str);
+        else
+            fputc(*str, file);
+    }
+    fputc('"', file);
+}
+
+/*
+ * Prints a hardware counter. Unavailable counters are printed as "missing" (an empty CSV field or a JSON null).
+ */
+static void fprint_counter(FILE *file, long long int value, const char *missing) {
+    if(value == PERF_COUNTER_UNAVAILABLE)
+        fprintf(file, "%s", missing);
+    else
+        fprintf(file, "%lld", value);
+}
+
+/*
+ * Opens the results files. Either path may be NULL, in which case that format isn't written.
+ * Returns NULL if a file couldn't be opened.
+ */
+ResultsWriter* results_writer_open(const char *csv_path, const char *jsonl_path)
+{
+    ResultsWriter *writer = malloc(sizeof(ResultsWriter));  assert(writer != NULL);
+    writer->csv = writer->jsonl = NULL;
+    writer->failed = false;
+    read_cpu_model(writer->cpu_model, CPU_MODEL_LEN);
+
+    if((csv_path != NULL && (writer->csv = fopen(csv_path, "w")) == NULL) ||
+       (jsonl_path != NULL && (writer->jsonl = fopen(jsonl_path, "w")) == NULL)) {
+        results_writer_close(writer);
+        return NULL;
+    }
+
+    if(writer->csv != NULL) {
+        fputs(CSV_HEADER, writer->csv);
+        fflush(writer->csv);
+    }
+    return writer;
+}
+
+/*
+ * Writes the record of a single repetition (the info returned for a single input) and flushes it to disk.
+ * Returns false if the record couldn't be written.
+ */
+bool results_writer_write(ResultsWriter *writer, const char *algorithm, const char *element_type, const char *input_case, size_t size, int repetition, SortingInfo *info)
+{
+    char timestamp[32];
+    time_t raw_time = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&raw_time));
+
+    unsigned int seed = get_random_seed();
+    const Samples *samples = get_time_samples(info);
+    long long int counters[] = {get_cycles(info), get_instructions(info), get_l1_misses(info), get_llc_misses(info), get_branch_misses(info)};
+    static const char *COUNTER_NAMES[] = {"cycles", "instructions", "l1_misses", "llc_misses", "branch_misses"};
+
+    if(writer->csv != NULL) {
+        FILE *f = writer->csv;
+        fprintf(f, "%s,", timestamp);
+        fprint_csv_string(f, algorithm);
+        fputc(',', f);
+        fprint_csv_string(f, element_type);
+        fputc(',', f);
+        fprint_csv_string(f, input_case);
+        fprintf(f, ",%zu,%d,%u,%.9lf,%.9lf,%lld,%lld", size, repetition, seed, get_execution_time(info), get_instrumented_time(info),
+                get_comparisons_count(info), get_swaps_count(info));
+        for(int i = 0; i < 5; i++) {
+            fputc(',', f);
+            fprint_counter(f, counters[i], "");
+        }
+
+        fprintf(f, ",%d,\"", samples->count); //the samples are separated by ';'
+        for(int i = 0; i < samples->count; i++)
+            fprintf(f, (i == 0) ? "%.9lf" : ";%.9lf", samples->values[i]);
+        fprintf(f, "\",");
+
+        fprint_csv_string(f, writer->cpu_model);
+        fputc(',', f);
+        fprint_csv_string(f, BUILD_FLAGS);
+        fputc(',', f);
+        fprint_csv_string(f, __VERSION__);
+        fputc('\n', f);
+
+        if(fflush(f) != 0 || ferror(f))
+            writer->failed = true;
+    }
+
+    if(writer->jsonl != NULL) {
+        FILE *f = writer->jsonl;
+        fprintf(f, "{\"timestamp\": \"%s\", \"algorithm\": ", timestamp);
+        fprint_json_string(f, algorithm);
+        fprintf(f, ", \"element_type\": ");
+        fprint_json_string(f, element_type);
+        fprintf(f, ", \"case\": ");
+        fprint_json_string(f, input_case);
+        fprintf(f, ", \"size\": %zu, \"repetition\": %d, \"seed\": %u, \"time\": %.9lf, \"instrumented_time\": %.9lf, \"comparisons\": %lld, \"swaps\": %lld",
+                size, repetition, seed, get_execution_time(info), get_instrumented_time(info), get_comparisons_count(info), get_swaps_count(info));
+        for(int i = 0; i < 5; i++) {
+            fprintf(f, ", \"%s\": ", COUNTER_NAMES[i]);
+            fprint_counter(f, counters[i], "null");
+        }
+
+        fprintf(f, ", \"samples\": [");
+        for(int i = 0; i < samples->count; i++)
+            fprintf(f, (i == 0) ? "%.9lf" : ", %.9lf", samples->values[i]);
+        fprintf(f, "], \"cpu_model\": ");
+        fprint_json_string(f, writer->cpu_model);
+        fprintf(f, ", \"build_flags\": ");
+        fprint_json_string(f, BUILD_FLAGS);
+        fprintf(f, ", \"compiler\": ");
+        fprint_json_string(f, __VERSION__);
+        fprintf(f, "}\n");
+
+        if(fflush(f) != 0 || ferror(f))
+            writer->failed = true;
+    }
+
+    return !writer->failed;
+}
+
+/*
+ * Closes the results files and frees the writer.
+ * Returns false if any of the writes failed.
+ */
+bool results_writer_close(ResultsWriter *writer)
+{
+    bool ok = !writer->failed;
+    if(writer->csv != NULL && fclose(writer->csv) != 0)
+        ok = false;
+    if(writer->jsonl != NULL && fclose(writer->jsonl) != 0)
+        ok = false;
+    free(writer);
+    return ok;
+}
@@ -0,0 +1,22 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef RESULTS_WRITER_H
+    #define RESULTS_WRITER_H
+
+    #include "sorting_algorithms.h"
+
+    /*
+     * Machine-readable results file(s). One record is written per (algorithm, element type, input case, size, repetition), as soon as it's measured, to a CSV file and/or a JSON Lines file.
+     * Every record carries its raw time samples and the context needed to compare runs: seed, build flags, CPU model and timestamp.
+     * The writer isn't thread-safe: concurrent writes must be serialized by the caller.
+     */
+    typedef struct ResultsWriter ResultsWriter;
+
+    ResultsWriter* results_writer_open(const char *csv_path, const char *jsonl_path);
+    bool results_writer_write(ResultsWriter *writer, const char *algorithm, const char *element_type, const char *input_case, size_t size, int repetition, SortingInfo *info);
+    bool results_writer_close(ResultsWriter *writer);
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+/*
+ * C ABI of the sort plugins: shared objects (loaded with "--plugin FILE" or from the menu) that add their own sorting algorithms to the benchmarks.
+ * A plugin includes only this header and exports a function named "sort_plugin" (SORT_PLUGIN_SYMBOL) that returns a pointer to a static SortPlugin. The strings and the functions it points to must stay valid while the program runs (plugins are never unloaded).
+ * See example_plugin.c.
+ */
+
+#ifndef SORT_PLUGIN_H
+    #define SORT_PLUGIN_H
+    #include <stddef.h>
+
+    #define SORT_PLUGIN_ABI_VERSION 1 //incremented whenever any of the structs below changes
+    #define SORT_PLUGIN_SYMBOL "sort_plugin"
+
+    //properties of an algorithm (bit flags), shown on the menu and in the results files; stable algorithms are checked for stability on the kv arrays
+    #define SORT_STABLE 1u
+    #define SORT_IN_PLACE 2u
+    #define SORT_PARALLEL 4u
+
+    /*
+     * Comparisons and swaps made by a plugin sort, which counts them only if it gets a non-NULL pointer (the instrumented run). Sorts that don't count them report 0.
+     */
+    typedef struct {
+        long long int comparisons, swaps;
+    } SortPluginCounters;
+
+    typedef void (*SortPluginFunction)(void *array, size_t size, SortPluginCounters *counters);
+
+    /*
+     * An algorithm of a plugin. Each function sorts an array of the corresponding element type in ascending order (NULL if the type isn't supported; sort_int is required):
+     * int, int64_t, float, double and 16-byte {int64_t key, value} records ordered by their keys.
+     * The id (letters, digits and '_') selects the algorithm in the batch mode and names its results files, so it must differ from the ids of the built-in algorithms.
+     */
+    typedef struct {
+        const char *id, *name;
+        unsigned int properties; //SORT_STABLE | SORT_IN_PLACE | SORT_PARALLEL
+        SortPluginFunction sort_int, sort_int64, sort_float, sort_double, sort_kv;
+    } SortPluginAlgorithm;
+
+    typedef struct {
+        int abi_version; //SORT_PLUGIN_ABI_VERSION
+        int num_algorithms;
+        const SortPluginAlgorithm *algorithms;
+    } SortPlugin;
+
+    typedef const SortPlugin* (*SortPluginEntry)(void); //type of the exported "sort_plugin" function
+#endif
@@ -3,36 +3,176 @@
  *  Gabriel Nogueira (Talendar)
  */
 
+#define _GNU_SOURCE //required for the CPU affinity functions
 #include "sorting_algorithms.h"
+#include "perf_counters.h"
+#include "results_writer.h"
+#include "sorting_networks.h"
+#include "dataset_cache.h"
+#include "buffers.h"
 #include <stdlib.h>
 #include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 #include <math.h>
 #include <assert.h>
 #include <string.h>
-
-bool seed_set = false; //set to true when the seed for the random int generator has been chosen
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+static int parallel_quicksort_threads = 0; //number of threads used by parallel_quicksort (0 = all the cores)
+static int network_leaf_size = 32; //sub-arrays up to this size are sorted by a network in quicksort_network and merge_sort_network
+static HeapVariant heap_variant = {.arity = 2, .bottom_up = false, .prefetch = false}; //heap used by heapsort (see set_heap_variant)
+static int heap_log_arity = 1; //log2 of the arity of the heap
+static int quicksort_partition = HOARE_PARTITION; //partitioning method of the quicksorts (see set_quicksort_partition)
+static int shellsort_gap_sequence = CIURA_GAPS; //gap sequence of shellsort (see set_shellsort_gaps)
+static int shellsort_threads = 1; //number of threads used by the h-sorts of shellsort (0 = all the cores)
+static int (*int64_comparator)(const void *a, const void *b) = &compare_int64; //comparator called by the int64_callback sorts
+static TimeBudget time_budget = {0, 0, 0}; //see set_time_budget
+static double budget_start_time = 0; //when the time budget was set
+static int heartbeat_fd = -1; //in the child process of a sort with a timeout, a byte is written to it after each sort (see measure_in_child)
 
 /*
  * Struct to hold the information about the execution of a sorting algorithm.
  */
 struct SortingInfo {
-    double time;
+    double time, instrumented_time; //wall clock time of the zero-overhead and of the instrumented version of the algorithm
     long long int comparisons_count, swaps_count;
+    PerfCounters hw; //hardware counters of the zero-overhead version (PERF_COUNTER_UNAVAILABLE if they couldn't be measured)
+    Samples samples; //time of each measured run of the zero-overhead version
+};
+
+/*
+ * Results of analyze_case: the mean performance and the time samples of each algorithm on each size, in a single num_algorithms x num_sizes matrix (one row per algorithm of the registry at the time).
+ */
+struct CaseResults {
+    int num_algorithms, num_sizes;
+    SortingInfo *cells;
+    struct {
+        int state; //CELL_MEASURED, CELL_SKIPPED, CELL_TIMED_OUT or CELL_NO_MEMORY
+        double predicted_time; //if skipped, the predicted time of the cell (0 if the total budget ran out); if timed out, the timeout
+    } *status;
 };
 
+/*
+ * Comparisons and swaps made by the instrumented version of a kernel and hardware counters measured by both versions.
+ */
+typedef struct {
+    long long int comparisons, swaps;
+    PerfCounters hw;
+} SortCounters;
+
 // getters
 double get_execution_time(SortingInfo *info) {return info->time;}
+double get_instrumented_time(SortingInfo *info) {return info->instrumented_time;}
 long long int get_comparisons_count(SortingInfo *info) {return info->comparisons_count;}
 long long int get_swaps_count(SortingInfo *info) {return info->swaps_count;}
+long long int get_cycles(SortingInfo *info) {return info->hw.cycles;}
+long long int get_instructions(SortingInfo *info) {return info->hw.instructions;}
+long long int get_l1_misses(SortingInfo *info) {return info->hw.l1_misses;}
+long long int get_llc_misses(SortingInfo *info) {return info->hw.llc_misses;}
+long long int get_branch_misses(SortingInfo *info) {return info->hw.branch_misses;}
+const Samples* get_time_samples(SortingInfo *info) {return &info->samples;}
+TimeStatistics get_time_statistics(SortingInfo *info) {return compute_statistics(&info->samples);}
 
 /*
- * Add the data from b to a and free b;
+ * Frees the given SortingInfo and its samples.
  */
-static void sum_info(SortingInfo *a, SortingInfo *b) {
+void free_sorting_info(SortingInfo *info) {
+    samples_free(&info->samples);
+    free(info);
+}
+
+/*
+ * Resets the given SortingInfo to an empty one, keeping the memory of its samples.
+ */
+static void clear_sorting_info(SortingInfo *info) {
+    info->time = info->instrumented_time = info->comparisons_count = info->swaps_count = 0;
+    info->hw = (PerfCounters) {0, 0, 0, 0, 0};
+    samples_clear(&info->samples);
+}
+
+/*
+ * Initializes an empty SortingInfo, to which the information of multiple executions will be added.
+ */
+static void init_sorting_info(SortingInfo *info) {
+    samples_init(&info->samples);
+    clear_sorting_info(info);
+}
+
+static SortingInfo* new_sorting_info(void)
+{
+    SortingInfo *info = malloc(sizeof(SortingInfo));  assert(info != NULL);
+    init_sorting_info(info);
+    return info;
+}
+
+/*
+ * Adds the hardware counter b to a. If any of them couldn't be measured, the result can't either.
+ */
+static void sum_counter(long long int *a, long long int b) {
+    *a = (*a == PERF_COUNTER_UNAVAILABLE || b == PERF_COUNTER_UNAVAILABLE) ? PERF_COUNTER_UNAVAILABLE : *a + b;
+}
+
+static void sum_counters(PerfCounters *a, const PerfCounters *b) {
+    sum_counter(&a->cycles, b->cycles);
+    sum_counter(&a->instructions, b->instructions);
+    sum_counter(&a->l1_misses, b->l1_misses);
+    sum_counter(&a->llc_misses, b->llc_misses);
+    sum_counter(&a->branch_misses, b->branch_misses);
+}
+
+/*
+ * Divides all the data in the given info by n (used to compute means). The counters are rounded to the nearest integer. The samples aren't changed.
+ */
+static void divide_info(SortingInfo *info, int n)
+{
+    info->time /= n;  info->instrumented_time /= n;
+    
+    long long int *counters[] = {&info->comparisons_count, &info->swaps_count, 
+                                 &info->hw.cycles, &info->hw.instructions, &info->hw.l1_misses, &info->hw.llc_misses, &info->hw.branch_misses};
+    for(int i = 0; i < 7; i++) {
+        if(*counters[i] != PERF_COUNTER_UNAVAILABLE)
+            *counters[i] = (*counters[i] + n/2) / n;
+    }
+}
+
+/*
+ * Add the data from b to a (appending its samples).
+ */
+static void sum_info(SortingInfo *a, const SortingInfo *b) {
     a->time += b->time;
+    a->instrumented_time += b->instrumented_time;
     a->comparisons_count += b->comparisons_count;
     a->swaps_count += b->swaps_count;
-    free(b);
+    sum_counters(&a->hw, &b->hw);
+    samples_append(&a->samples, &b->samples);
+}
+
+/*
+ * Allocates an array of "count" elements of "elem_size" bytes. Used for the buffers whose size depends on the size of the sorted arrays: if there isn't enough memory (or the size overflows), the program is aborted with an error message and the EXIT_OUT_OF_MEMORY exit code.
+ */
+void* checked_malloc(size_t count, size_t elem_size)
+{
+    void *p = (elem_size == 0 || count <= SIZE_MAX / elem_size) ? malloc((count > 0 ? count : 1) * elem_size) : NULL;
+    if(p == NULL) {
+        fprintf(stderr, "\n\nERROR: couldn't allocate %zu elements of %zu bytes (not enough memory). Aborting...\n", count, elem_size);
+        exit(EXIT_OUT_OF_MEMORY);
+    }
+    return p;
+}
+
+/*
+ * Tries to allocate an array of "size" elements of "elem_size" bytes. Returns NULL if there isn't enough memory, so that the generators can report it to the caller.
+ */
+static void* try_alloc_array(size_t size, size_t elem_size) {
+    return (size <= SIZE_MAX / elem_size) ? malloc((size > 0 ? size : 1) * elem_size) : NULL;
 }
 
 /*
@@ -48,8 +188,8 @@ void swap(int *a, int *b)
 /*
  * Returns true if the array is sorted, false otherwise.
  */
-bool is_sorted(int *array, int size) {
-    for(int i = 0; i < size - 1; i++) {
+bool is_sorted(int *array, size_t size) {
+    for(size_t i = 0; i + 1 < size; i++) {
         if(array[i] > array[i+1])
             return false;
     }
@@ -57,573 +197,1440 @@ bool is_sorted(int *array, int size) {
 }
 
 /*
- * Generates a random int array with the specified size. Each element will be within the range [0, size - 1].
+ * Maps the index i of an array whose elements go up to "max" (> INT_MAX for arrays with more than 2^31 elements) to an int, preserving their order. Indices that don't fit into an int are scaled down, which creates duplicated elements.
  */
-int* random_array(int size) 
-{
-    if(!seed_set) {
-        srand(time(NULL));
-        seed_set = true;
+int scaled_value(size_t i, size_t max) {
+    return (max <= INT_MAX) ? (int) i : (int) ((double) i * ((double) INT_MAX / (double) max));
+}
+
+/*
+ * Orderings of the element types (see kernel_instances.inc) and the element built out of the value v generated for the index i, whose case goes up to "max" (see get_case_max_value).
+ */
+#define LESS_VALUE(a, b) ((a) < (b))
+#define LESS_KEY(a, b) ((a).key < (b).key)
+#define LESS_CALLBACK(a, b) (int64_comparator(&(a), &(b)) < 0)
+#define MAKE_INT(v, i, max) scaled_value(v, max)
+#define MAKE_INT64(v, i, max) ((int64_t) (v))
+#define MAKE_FLOAT(v, i, max) ((float) (v))
+#define MAKE_DOUBLE(v, i, max) ((double) (v))
+#define MAKE_KV(v, i, max) ((KeyValue) {(int64_t) (v), (int64_t) (i)})
+
+#define GENERATOR_BATCH 1024 //values generated at a time by the fill functions
+
+/*
+ * Defines the generator of an element type. The values come from generate_values, so they're the same for all the types, except that the ints are scaled down when they don't fit (for floats, values beyond 2^24 are rounded, which creates duplicated elements).
+ * The arrays are filled in parallel by fill_array, which calls fill<suffix> on chunks of the array. "generate_into<suffix>" fills a buffer given by the caller.
+ */
+#define DEFINE_GENERATOR(suffix, type, make) \
+    static void fill##suffix(void *array, int array_case, size_t size, int sample, size_t first, size_t count) { \
+        type *a = array; \
+        size_t values[GENERATOR_BATCH], max = get_case_max_value(array_case, size); \
+        (void) max; /* only the ints are scaled to it (see MAKE_INT) */ \
+        for(size_t done = 0; done < count; done += GENERATOR_BATCH) { \
+            size_t n = (count - done < GENERATOR_BATCH) ? count - done : GENERATOR_BATCH; \
+            generate_values(array_case, size, sample, first + done, n, values); \
+            for(size_t j = 0; j < n; j++) \
+                a[first + done + j] = make(values[j], first + done + j, max); \
+        } \
+    } \
+    static void generate_into##suffix(void *array, int array_case, size_t size, int sample) { \
+        fill_array(array, sizeof(type), size, array_case, sample, &fill##suffix); \
+    } \
+    type* generate_array##suffix(int array_case, size_t size, int sample) { \
+        type *a = try_alloc_array(size, sizeof(type)); \
+        if(a != NULL) \
+            generate_into##suffix(a, array_case, size, sample); \
+        return a; \
     }
 
-    int *a = malloc(size * sizeof(int));
-    for(int i = 0; i < size; i++) {
-        a[i] = rand() % size;
+/*
+ * Defines the generator and the is_sorted function of an element type other than int.
+ */
+#define DEFINE_TYPED_GENERATORS(suffix, type, make, less) \
+    DEFINE_GENERATOR(suffix, type, make) \
+    bool is_sorted##suffix(const type *array, size_t size) { \
+        for(size_t i = 0; i + 1 < size; i++) { \
+            if(less(array[i+1], array[i])) \
+                return false; \
+        } \
+        return true; \
     }
 
-    return a;
+DEFINE_GENERATOR(, int, MAKE_INT)
+DEFINE_TYPED_GENERATORS(_int64, int64_t, MAKE_INT64, LESS_VALUE)
+DEFINE_TYPED_GENERATORS(_float, float, MAKE_FLOAT, LESS_VALUE)
+DEFINE_TYPED_GENERATORS(_double, double, MAKE_DOUBLE, LESS_VALUE)
+DEFINE_TYPED_GENERATORS(_kv, KeyValue, MAKE_KV, LESS_KEY)
+
+// generators of the classic cases (int)
+int* random_array(size_t size) {return generate_array(RANDOM_CASE, size, 0);}
+int* almost_sorted_array(size_t size) {return generate_array(ALMOST_SORTED_CASE, size, 0);}
+int* sorted_array(size_t size) {return generate_array(SORTED_CASE, size, 0);}
+int* inversely_sorted_array(size_t size) {return generate_array(INVERSELY_SORTED_CASE, size, 0);}
+int* few_unique_array(size_t size) {return generate_array(FEW_UNIQUE_CASE, size, 0);}
+
+/*
+ * Default comparator of the int64_callback sorts (qsort-style: negative if a < b, 0 if a == b and positive if a > b).
+ */
+int compare_int64(const void *a, const void *b) {
+    int64_t x = *(const int64_t*) a, y = *(const int64_t*) b;
+    return (x > y) - (x < y);
 }
 
 /*
- * Returns an almost sorted array where each of the "size" elements may be misplaced by no more than "k" positions from the correct sorted order.
+ * Sets the comparator called by the int64_callback sorts. Since it can be changed at any time, the calls can't be inlined.
  */
-int* almost_sorted_array(int size, int k)
-{
-    if(!seed_set) {
-        srand(time(NULL));
-        seed_set = true;
-    }
+void set_int64_comparator(int (*compare)(const void *a, const void *b)) {
+    int64_comparator = compare;
+}
 
-    int *a = malloc(size * sizeof(int));
-    for(int i = 0; i < size; i++) {
-        int entropy = rand() % (k + 1);
-        a[i] = i + entropy;
-    }
+/*
+ * An element type, with its generator and the kernels of its algorithms wrapped so that they can be called on arrays of any type (see DEFINE_TYPED_SORT). The kernels write their counters to the caller's SortCounters and return the time, so the harness doesn't allocate anything per run.
+ * The entries of the algorithms that aren't built for the type are NULL.
+ */
+typedef struct {
+    char *id, *name;
+    size_t elem_size;
+    double (*kernels[NUM_BUILTIN_ALGORITHMS])(void *array, size_t size, SortCounters *counters);
+    double (*clean_kernels[NUM_BUILTIN_ALGORITHMS])(void *array, size_t size, SortCounters *counters);
+    void (*generate)(void *array, int array_case, size_t size, int sample);
+    bool (*is_sorted)(const void *array, size_t size);
+    bool (*is_stably_sorted)(const void *array, size_t size); //also checks the order of equal elements (NULL if it can't be checked)
+} ElementType;
+
+static const ElementType ELEMENT_TYPES[NUM_ELEMENT_TYPES]; //defined after the algorithms
+
+/*
+ * An algorithm of the registry. The built-in ones are sorted by the kernels of the element types table; the plugins only by their own functions (one per element type, NULL if the type isn't supported).
+ */
+typedef struct {
+    const char *id, *name;
+    unsigned int properties;
+    SortingInfo* (*sort)(int *array, size_t size);
+    SortingInfo* (*sort_clean)(int *array, size_t size);
+    SortPluginFunction plugin_sorts[NUM_ELEMENT_TYPES];
+} Algorithm;
+
+static Algorithm ALGORITHMS[MAX_ALGORITHMS]; //defined after the algorithms
+static int num_algorithms = NUM_BUILTIN_ALGORITHMS;
 
-    return a;
+// getters for the element types table
+const char* get_element_type_id(int type) {return ELEMENT_TYPES[type].id;}
+const char* get_element_type_name(int type) {return ELEMENT_TYPES[type].name;}
+
+/*
+ * Returns true if the given algorithm can sort arrays of the given element type.
+ */
+bool is_algorithm_available(int type, int algorithm) {
+    if(algorithm < NUM_BUILTIN_ALGORITHMS)
+        return ELEMENT_TYPES[type].kernels[algorithm] != NULL;
+    return ALGORITHMS[algorithm].plugin_sorts[type] != NULL;
 }
 
 /*
- * Returns a sorted int array with elements within the range [0, size - 1].
+ * Returns the index of the element type with the given id or -1 if there's no such type.
  */
-int* sorted_array(int size)
+int find_element_type(const char *id)
 {
-    int *a = malloc(size * sizeof(int));
-    for(int i = 0; i < size; i++) {
-        a[i] = i;
+    for(int i = 0; i < NUM_ELEMENT_TYPES; i++) {
+        if(strcmp(ELEMENT_TYPES[i].id, id) == 0)
+            return i;
     }
-
-    return a;
+    return -1;
 }
 
+static double run_kernel(const ElementType *type, int algorithm, void *array, size_t size, SortCounters *counters, bool instrumented); //defined after the timing functions
+
 /*
- * Returns a reversely sorted int array with elements within the range [0, size - 1].
+ * Sorts copies of "array" (made in "temp_array") with the zero-overhead kernel of an algorithm (built for the given element type) and then another copy with its instrumented kernel.
+ * If "config" isn't NULL, the zero-overhead version is first run (without being measured) config->warmup_runs times and then measured until the relative error of the mean time gets below the target (see StatisticsConfig). Otherwise, it's measured once.
+ * If "max_seconds" > 0, no more warmup and measured runs are started once that much time has passed (but at least one run is measured), which caps the cost of the statistics mode.
+ * Writes the mean time, the hardware counters and the time samples of the zero-overhead version and the counters and time of the instrumented one to "info" (which is cleared first), so nothing is allocated unless its samples list has to grow. "sorted" is set to false if any of the copies wasn't sorted correctly (or, for the stable algorithms, if the order of equal elements changed, when it can be checked).
  */
-int* inversely_sorted_array(int size)
+static void measure_sort(const ElementType *type, int algorithm, const void *array, void *temp_array, size_t size, const StatisticsConfig *config, double max_seconds, SortingInfo *info, bool *sorted)
 {
-    int *a = malloc(size * sizeof(int));
-    for(int i = 0; i < size; i++) {
-        a[i] = size - 1 - i;
+    double start = monotonic_time();
+    bool (*check)(const void *array, size_t size) = type->is_sorted;
+    if((ALGORITHMS[algorithm].properties & SORT_STABLE) && type->is_stably_sorted != NULL)
+        check = type->is_stably_sorted;
+    size_t bytes = size * type->elem_size;
+    SortCounters counters;
+
+    clear_sorting_info(info);
+    *sorted = true;
+    for(int i = 0; config != NULL && i < config->warmup_runs && (max_seconds <= 0 || monotonic_time() - start < max_seconds); i++) {
+        memcpy(temp_array, array, bytes);
+        counters = (SortCounters) {0};
+        run_kernel(type, algorithm, temp_array, size, &counters, false);
     }
 
-    return a;
+    int runs = 0;
+    while(true) {
+        memcpy(temp_array, array, bytes);
+        counters = (SortCounters) {0};
+        double time = run_kernel(type, algorithm, temp_array, size, &counters, false);
+        *sorted = *sorted && check(temp_array, size);
+        info->time += time;
+        sum_counters(&info->hw, &counters.hw);
+        samples_add(&info->samples, time);
+        runs++;
+
+        if(config == NULL || (config->max_runs > 0 && runs >= config->max_runs) || (max_seconds > 0 && monotonic_time() - start >= max_seconds))
+            break;
+        if(runs >= config->min_runs) {
+            TimeStatistics stats = compute_statistics(&info->samples);
+            if(relative_error(&stats) <= config->target_relative_error)
+                break;
+        }
+    }
+    divide_info(info, runs);
+
+    memcpy(temp_array, array, bytes);
+    counters = (SortCounters) {0};
+    info->instrumented_time = run_kernel(type, algorithm, temp_array, size, &counters, true);
+    *sorted = *sorted && check(temp_array, size);
+    info->comparisons_count = counters.comparisons;
+    info->swaps_count = counters.swaps;
 }
 
 /*
- * Run the given sorting algorithm "num_execution" times on arrays with the given "size" generated by the function "generate_array".
+ * Run the given sorting algorithm "num_execution" times on arrays of the given element type, case and "size". Each array is sorted by both versions of the algorithm (instrumented and zero-overhead). If "config" isn't NULL, the statistics mode is used (see measure_sort).
+ * The input and work buffers are allocated (and prefaulted) once and reused by all the executions.
  * Returns a pointer to a SortingInfo "object" containing informations about the algorithm's performance.
  */
-SortingInfo* analyze_sorting_algorithm(SortingInfo* (*sort)(int *array, int size), int* (*generate_array)(int size), int size, int num_executions)
+SortingInfo* analyze_sorting_algorithm(int type, int algorithm, int array_case, size_t size, int num_executions, const StatisticsConfig *config)
 {
-    SortingInfo *info = malloc(sizeof(SortingInfo));
-    info->time = info->comparisons_count = info->swaps_count = 0;
+    assert(is_algorithm_available(type, algorithm));
+    const ElementType *element_type = &ELEMENT_TYPES[type];
+    Buffer input, work;
+    if(!alloc_buffer(&input, size, element_type->elem_size) || !alloc_buffer(&work, size, element_type->elem_size)) {
+        fprintf(stderr, "\n\nERROR: not enough memory to generate an array of size %zu. Aborting...\n", size);
+        exit(EXIT_OUT_OF_MEMORY);
+    }
 
+    SortingInfo *info = new_sorting_info(), run_info;
+    init_sorting_info(&run_info);
     for(int i = 0; i < num_executions; i++) {
-        sum_info(info, sort(generate_array(size), size));
+        bool sorted;
+        load_dataset(element_type->id, element_type->elem_size, array_case, size, i, input.data, element_type->generate);
+        measure_sort(element_type, algorithm, input.data, work.data, size, config, 0, &run_info, &sorted);
+        assert(sorted);
+        sum_info(info, &run_info);
     }
 
-    info->time /= num_executions;  info->comparisons_count /= num_executions;  info->swaps_count /= num_executions;
+    samples_free(&run_info.samples);
+    free_buffer(&input);  free_buffer(&work);
+    divide_info(info, num_executions);
     return info;
 }
 
 /*
- * Helper for the analyze_case_on_all function.
+ * Measures the given algorithm on a copy of "array" (made in "temp_array", which must have room for "size" elements of the given type), like analyze_sorting_algorithm does with one execution, but on an array given by the caller. If "config" isn't NULL, the statistics mode is used (see measure_sort).
+ * "sorted" is set to false if any of the copies wasn't sorted correctly. Returns a pointer to a SortingInfo "object" with the results (including the time samples).
  */
-static void help_analyze_all(SortingInfo ***info, int alg_index, int size_index, char *name, SortingInfo* (*sort)(int *a, int n), int *array, int *temp_array, int size) 
+SortingInfo* measure_sorting_algorithm(int type, int algorithm, const void *array, void *temp_array, size_t size, const StatisticsConfig *config, bool *sorted)
 {
-    printf("\t\t\t-> %s...", name); 
-    fflush(stdout); 
-
-    memcpy(temp_array, array, size * sizeof(int));  
-    SortingInfo *temp_info = sort(temp_array, size);
-    
-    if(!is_sorted(temp_array, size)) { //check if the sorting was sucessful
-        printf("\n\nERROR: %s couldn't sort the given array. The array isn't sorted correctly. Aborting...\n", name);
-        exit(1);
-    }
+    assert(is_algorithm_available(type, algorithm));
+    SortingInfo *info = new_sorting_info();
+    measure_sort(&ELEMENT_TYPES[type], algorithm, array, temp_array, size, config, 0, info, sorted);
+    return info;
+}
 
-    printf("OK! (%.6lfs)\n", temp_info->time);
-    sum_info(info[alg_index][size_index], temp_info);
+/*
+ * Sorts the sample 0 of an array of the given element type, case and "size" with both versions of the given algorithm (see measure_sort). Used by the tests. Returns false if any of them didn't sort it correctly.
+ */
+bool verify_sorting_algorithm(int type, int algorithm, int array_case, size_t size)
+{
+    assert(is_algorithm_available(type, algorithm));
+    const ElementType *element_type = &ELEMENT_TYPES[type];
+    void *array = checked_malloc(size, element_type->elem_size), *temp_array = checked_malloc(size, element_type->elem_size);
+    element_type->generate(array, array_case, size, 0);
+
+    SortingInfo info;
+    init_sorting_info(&info);
+    bool sorted;
+    measure_sort(element_type, algorithm, array, temp_array, size, NULL, 0, &info, &sorted);
+
+    samples_free(&info.samples);
+    free(array);  free(temp_array);
+    return sorted;
 }
 
-/* 
- *
- * Algorithms indexes: bubble_sort[0], flagged_bubble_sort[1], selection_sort[2], insertion_sort[3], heapsort[4], shellsort[5], quicksort[6], merge_sort[7].
+/*
+ * Algorithms run by analyze_case: the built-in ones, followed by the ones added by register_algorithm. The position of an algorithm in this table is its index in the returned matrix. The id is used to select the algorithm in the batch mode and to name its results file.
  */
-SortingInfo*** analyze_case_on_all(int* (*generate_array)(int size), int min_size_exp, int max_size_exp, int num_executions)
+static Algorithm ALGORITHMS[MAX_ALGORITHMS] = {
+    {"bubble_sort", "Bubble Sort", SORT_STABLE | SORT_IN_PLACE, &bubble_sort, &bubble_sort_clean}, 
+    {"flagged_bubble_sort", "Flagged Bubble Sort", SORT_STABLE | SORT_IN_PLACE, &flagged_bubble_sort, &flagged_bubble_sort_clean}, 
+    {"selection_sort", "Selection Sort", SORT_IN_PLACE, &selection_sort, &selection_sort_clean}, 
+    {"insertion_sort", "Insertion Sort", SORT_STABLE | SORT_IN_PLACE, &insertion_sort, &insertion_sort_clean}, 
+    {"heapsort", "Heapsort", SORT_IN_PLACE, &heapsort, &heapsort_clean}, 
+    {"shellsort", "Shellsort", SORT_IN_PLACE | SORT_PARALLEL, &shellsort, &shellsort_clean}, 
+    {"quicksort", "Quicksort", SORT_IN_PLACE, &quicksort, &quicksort_clean}, 
+    {"merge_sort", "Merge Sort", SORT_STABLE, &merge_sort, &merge_sort_clean}, 
+    {"introsort", "Introsort (pattern-defeating hybrid quicksort)", SORT_IN_PLACE, &introsort, &introsort_clean}, 
+    {"timsort", "Timsort (adaptive natural merge sort)", SORT_STABLE, &timsort, &timsort_clean}, 
+    {"merge_sort_top_down", "Merge Sort (top-down, scratch buffer)", SORT_STABLE, &merge_sort_top_down, &merge_sort_top_down_clean},
+    {"merge_sort_bottom_up", "Merge Sort (bottom-up, scratch buffer)", SORT_STABLE, &merge_sort_bottom_up, &merge_sort_bottom_up_clean}, 
+    {"parallel_quicksort", "Parallel Quicksort", SORT_IN_PLACE | SORT_PARALLEL, &parallel_quicksort, &parallel_quicksort_clean},
+    {"lsd_radix_sort", "LSD Radix Sort (8-bit digits)", SORT_STABLE, &lsd_radix_sort, &lsd_radix_sort_clean}, 
+    {"lsd_radix_sort_11bit", "LSD Radix Sort (11-bit digits)", SORT_STABLE, &lsd_radix_sort_11bit, &lsd_radix_sort_11bit_clean}, 
+    {"msd_radix_sort", "MSD Radix Sort (American flag)", SORT_IN_PLACE, &msd_radix_sort, &msd_radix_sort_clean},
+    {"quicksort_network", "Quicksort (sorting network leaves)", SORT_IN_PLACE, &quicksort_network, &quicksort_network_clean},
+    {"merge_sort_network", "Merge Sort (sorting network leaves)", 0, &merge_sort_network, &merge_sort_network_clean}
+};
+
+// getters for the algorithms table
+int get_num_algorithms(void) {return num_algorithms;}
+const char* get_algorithm_id(int index) {return ALGORITHMS[index].id;}
+const char* get_algorithm_name(int index) {return ALGORITHMS[index].name;}
+unsigned int get_algorithm_properties(int index) {return ALGORITHMS[index].properties;}
+bool is_plugin_algorithm(int index) {return index >= NUM_BUILTIN_ALGORITHMS;}
+SortingInfo* (*get_algorithm_sort(int index, bool instrumented))(int *array, size_t size) {return instrumented ? ALGORITHMS[index].sort : ALGORITHMS[index].sort_clean;}
+
+/*
+ * Returns the index of the algorithm with the given id or -1 if there's no such algorithm.
+ */
+int find_algorithm(const char *id)
 {
-    int num_sizes = max_size_exp - min_size_exp + 1; //number of different array sizes
+    for(int i = 0; i < num_algorithms; i++) {
+        if(strcmp(ALGORITHMS[i].id, id) == 0)
+            return i;
+    }
+    return -1;
+}
 
-    //alocating holders for the sorting info
-    SortingInfo ***info = malloc(8 * sizeof(SortingInfo**));  assert(info != NULL);
-    for(int i = 0; i < 8; i++) {
-        info[i] = malloc(num_sizes * sizeof(SortingInfo*));  assert(info[i] != NULL);
-        for(int j = 0; j < num_sizes; j++) {
-            info[i][j] = malloc(sizeof(SortingInfo));  assert(info[i][j] != NULL);
-            info[i][j]->time = info[i][j]->comparisons_count = info[i][j]->swaps_count = 0;
-        }
+/*
+ * Adds an algorithm sorted by the given functions (one per element type, NULL for the types it doesn't support; the int one is required) to the end of the registry. The strings aren't copied. Not thread-safe: must be called before any benchmark starts.
+ * Returns the index of the algorithm, or -1 if the registry is full, the id is invalid or already taken, or there's no int function.
+ */
+int register_algorithm(const char *id, const char *name, unsigned int properties, const SortPluginFunction sorts[NUM_ELEMENT_TYPES])
+{
+    if(num_algorithms == MAX_ALGORITHMS || id == NULL || name == NULL || id[0] == '\0' || strlen(id) > 64 || strcmp(id, "all") == 0 
+       || find_algorithm(id) >= 0 || sorts[INT_ELEMENTS] == NULL)
+        return -1;
+    for(const char *c = id; *c != '\0'; c++) {
+        if(!(*c == '_' || (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9')))
+            return -1;
     }
 
-    //sorting
-    for(int k = min_size_exp; k <= max_size_exp; k++) {
-        int size = pow(10, k);
-        int *temp_array = malloc(size * sizeof(int));
-        printf("\t-> SIZE: 10^%d\n", k);
-
-        for(int n = 0; n < num_executions; n++) {
-            printf("\t\t-> Execution %d/%d\n", n+1, num_executions);
-            int *array = generate_array(size);
-
-            int size_index = k - min_size_exp;
-            help_analyze_all(info, 0, size_index, "Bubble Sort", &bubble_sort, array, temp_array, size);
-            help_analyze_all(info, 1, size_index, "Flagged Bubble Sort", &flagged_bubble_sort, array, temp_array, size);
-            help_analyze_all(info, 2, size_index, "Selection Sort", &selection_sort, array, temp_array, size);
-            help_analyze_all(info, 3, size_index, "Insertion Sort", &insertion_sort, array, temp_array, size);
-            help_analyze_all(info, 4, size_index, "Heapsort", &heapsort, array, temp_array, size);
-            help_analyze_all(info, 5, size_index, "Shellsort", &shellsort, array, temp_array, size);
-            help_analyze_all(info, 6, size_index, "Quicksort", &quicksort, array, temp_array, size);
-            help_analyze_all(info, 7, size_index, "Merge Sort", &merge_sort, array, temp_array, size);
-            
-            free(array);
-        }
-        free(temp_array);
+    Algorithm *algorithm = &ALGORITHMS[num_algorithms];
+    *algorithm = (Algorithm) {id, name, properties & (SORT_STABLE | SORT_IN_PLACE | SORT_PARALLEL), NULL, NULL, {NULL}};
+    memcpy(algorithm->plugin_sorts, sorts, sizeof(algorithm->plugin_sorts));
+    return num_algorithms++;
+}
 
-        //mean of the performance for the current array size
-        for(int i = 0; i < 8; i++) {
-            SortingInfo *s = info[i][k - min_size_exp];
+/*
+ * A single job of the parallel scheduler: sorting a private copy of one of the shared input arrays with one of the algorithms.
+ */
+typedef struct {
+    int alg_index, size_index, execution;
+    const void *input;
+    size_t size;
+} BenchmarkJob;
 
-            s->time /= num_executions;
-            s->comparisons_count /= num_executions;
-            s->swaps_count /= num_executions;
-        }
-    }
+/*
+ * Jobs shared by all the workers of the parallel scheduler. Every field but "jobs" is protected by "lock".
+ */
+typedef struct {
+    BenchmarkJob *jobs;
+    int num_jobs, next_job, num_executions;
+    const StatisticsConfig *config;
+    CaseResults *results;
+    const ElementType *type;
+    const char *case_id; //name of the input case in the records of the results writer
+    ResultsWriter *writer; //NULL if the records aren't streamed
+    pthread_mutex_t lock;
+} BenchmarkQueue;
+
+typedef struct {
+    BenchmarkQueue *queue;
+    int worker_id;
+    bool pin;
+    Buffer *work; //prefaulted by analyze_case, big enough for the largest array
+} BenchmarkWorker;
 
-    return info;
+/*
+ * Returns the number of processors currently online.
+ */
+int get_num_cores(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n < 1) ? 1 : (int) n;
 }
 
 /*
- * Save the given sorting informations in the given .txt file.
+ * Pins the calling thread to the given core (modulo the number of cores).
  */
-void save_sorting_info(SortingInfo *rand_info, SortingInfo* semi_info, SortingInfo* inv_info, SortingInfo* sorted_info, int arrays_size, int num_executions, FILE *file)
+static void pin_to_core(int core)
 {
-    fprintf(file, "\t< ARRAYS SIZE: %d (%.0e)  |  NUMBER OF EXECUTIONS: %d >\n", arrays_size, (double) arrays_size, num_executions);
-    fprintf(file, "\t\t[RANDOM ARRAYS]  Time: %.8lfs  |  Comparisons: %lld  |  Swaps: %lld\n", 
-            get_execution_time(rand_info), get_comparisons_count(rand_info), get_swaps_count(rand_info));
-    fprintf(file, "\t\t[SEMI SORTED ARRAYS]  Time: %.8lfs  |  Comparisons: %lld  |  Swaps: %lld\n", 
-            get_execution_time(semi_info), get_comparisons_count(semi_info), get_swaps_count(semi_info));
-    fprintf(file, "\t\t[INVERSELY SORTED ARRAYS]  Time: %.8lfs  |  Comparisons: %lld  |  Swaps: %lld\n", 
-            get_execution_time(inv_info), get_comparisons_count(inv_info), get_swaps_count(inv_info));
-    fprintf(file, "\t\t[SORTED ARRAYS]  Time: %.8lfs  |  Comparisons: %lld  |  Swaps: %lld\n\n", 
-            get_execution_time(sorted_info), get_comparisons_count(sorted_info), get_swaps_count(sorted_info));
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % get_num_cores(), &set);
+
+    if(pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set) != 0)
+        fprintf(stderr, "WARNING: couldn't pin worker %d to a core.\n", core);
+}
+
+/*
+ * Sets the time budget of the benchmarks (see TimeBudget and analyze_case). The total budget starts counting now. Not thread-safe: must be called before any benchmark starts.
+ */
+void set_time_budget(TimeBudget budget) {
+    time_budget = budget;
+    budget_start_time = monotonic_time();
+}
+
+TimeBudget get_time_budget(void) {return time_budget;}
+
+static bool has_time_budget(void) {
+    return time_budget.cell_seconds > 0 || time_budget.total_seconds > 0 || time_budget.timeout_seconds > 0;
 }
 
 /*
- * Non-optimized version of the bubble sort algorithm.
+ * Returns the time left of the total budget (INFINITY if there's no total budget).
  */
-SortingInfo* bubble_sort(int *array, int size)
+static double remaining_budget(void) {
+    return (time_budget.total_seconds > 0) ? time_budget.total_seconds - (monotonic_time() - budget_start_time) : INFINITY;
+}
+
+/*
+ * Writes (or reads) exactly "len" bytes to (or from) a pipe. Returns false if it was closed first.
+ */
+static bool write_all(int fd, const void *data, size_t len)
 {
-    SortingInfo *info = malloc(sizeof(SortingInfo));
-    info->comparisons_count = info->swaps_count = 0;
-    clock_t starting_clock = clock();
+    for(const char *p = data; len > 0; ) {
+        ssize_t n = write(fd, p, len);
+        if(n < 0 && errno == EINTR)
+            continue;
+        if(n <= 0)
+            return false;
+        p += n;  len -= n;
+    }
+    return true;
+}
 
-    for(int i = size-1; i >= 1; i--) {
-        for(int j = 0; j < i; j++) {
-            info->comparisons_count++;
-            if(array[j] > array[j+1]) {
-                swap(&array[j], &array[j+1]);
-                info->swaps_count++;
-            }
-        }
+static bool read_all(int fd, void *data, size_t len)
+{
+    for(char *p = data; len > 0; ) {
+        ssize_t n = read(fd, p, len);
+        if(n < 0 && errno == EINTR)
+            continue;
+        if(n <= 0)
+            return false;
+        p += n;  len -= n;
     }
-    
-    info->time = ( (double) (clock() - starting_clock) ) / CLOCKS_PER_SEC;
-    return info;
+    return true;
 }
 
+#define JOB_DONE 0
+#define JOB_TIMED_OUT 1
+
 /*
- * Optimized (flagged or with sentinel) version of the bubble sort algorithm.
+ * Runs measure_sort in a child process, which is killed if any single sort takes longer than the timeout of the time budget: the child writes a byte to a pipe after each sort (see run_kernel) and then its results, which are copied to "info" and "sorted".
+ * The child prefaults the work buffer again, since its pages are shared copy-on-write with the parent, so that no fault happens inside a timed region. Returns JOB_TIMED_OUT if the child was killed and JOB_DONE otherwise. If the child fails (e.g. it crashes), the program is aborted.
  */
-SortingInfo* flagged_bubble_sort(int *array, int size)
+static int measure_in_child(const ElementType *type, int algorithm, const void *array, Buffer *work, size_t size, const StatisticsConfig *config, double max_seconds, SortingInfo *info, bool *sorted)
 {
-    SortingInfo *info = malloc(sizeof(SortingInfo));
-    info->comparisons_count = info->swaps_count = 0;
-    clock_t starting_clock = clock();
+    int fds[2];
+    fflush(stdout); //the child doesn't print anything, but it may exit through exit()
+    pid_t pid = (pipe(fds) == 0) ? fork() : -1;
+    if(pid < 0) {
+        fprintf(stderr, "\n\nERROR: couldn't start a child process for %s. Aborting...\n", ALGORITHMS[algorithm].name);
+        exit(EXIT_FAILURE);
+    }
 
-    bool sorted; //this flag/sentinel will be set to true when no swaps have been made during an iteration
-    int i = size - 1;
+    if(pid == 0) {
+        close(fds[0]);
+        perf_counters_close(); //the inherited counters count the parent's thread
+        prefault_buffer(work);
+        heartbeat_fd = fds[1];
+        measure_sort(type, algorithm, array, work->data, size, config, max_seconds, info, sorted);
+        bool sent = write_all(fds[1], "r", 1) && write_all(fds[1], info, sizeof(SortingInfo)) && write_all(fds[1], sorted, sizeof(bool))
+                    && write_all(fds[1], info->samples.values, info->samples.count * sizeof(double));
+        _exit(sent ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
 
-    do {
-        sorted = true;
-        for(int j = 0; j < i; j++) {
-            info->comparisons_count++;
-            if(array[j] > array[j+1]) {
-                swap(&array[j], &array[j+1]);
-                info->swaps_count++;
-                sorted = false;
-            }
+    close(fds[1]);
+    int outcome = JOB_DONE;
+    char tag = 'h';
+    while(tag == 'h') {
+        struct pollfd readable = {fds[0], POLLIN, 0};
+        int ready;
+        do {
+            ready = poll(&readable, 1, (int) ceil(time_budget.timeout_seconds * 1000));
+        } while(ready < 0 && errno == EINTR);
+
+        if(ready == 0) {
+            kill(pid, SIGKILL);
+            outcome = JOB_TIMED_OUT;
+            break;
         }
-        i--;
-    } while(!sorted);
-    
-    info->time = ( (double) (clock() - starting_clock) ) / CLOCKS_PER_SEC;
-    return info;
+        if(!read_all(fds[0], &tag, 1))
+            tag = '\0'; //the child exited without sending its results
+    }
+
+    //the results: the SortingInfo (whose samples list is replaced by the parent's one), the sorted flag and the samples
+    bool received = false;
+    if(tag == 'r') {
+        Samples samples = info->samples;
+        received = read_all(fds[0], info, sizeof(SortingInfo)) && read_all(fds[0], sorted, sizeof(bool));
+        int count = info->samples.count;
+        info->samples = samples;
+        samples_clear(&info->samples);
+        if(received) {
+            samples_reserve(&info->samples, count);
+            received = read_all(fds[0], info->samples.values, count * sizeof(double));
+            info->samples.count = received ? count : 0;
+        }
+    }
+    close(fds[0]);
+
+    int status;
+    while(waitpid(pid, &status, 0) < 0 && errno == EINTR);
+    if(outcome == JOB_DONE && !received) {
+        if(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_OUT_OF_MEMORY) //the child already printed the error
+            exit(EXIT_OUT_OF_MEMORY);
+        fprintf(stderr, "\n\nERROR: %s failed in its child process (%s %d). Aborting...\n", ALGORITHMS[algorithm].name,
+                WIFSIGNALED(status) ? "signal" : "exit code", WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status));
+        exit(EXIT_FAILURE);
+    }
+    return outcome;
 }
 
 /*
- * Selection sort algorithm.
+ * Body of a worker thread of the parallel scheduler. Keeps taking jobs from the queue until it's empty. Each worker has its own work buffer (see analyze_case), where the shared input is copied to before being sorted.
+ * The results of each job are written to a SortingInfo of the worker, reused by all of its jobs, and then added to the results matrix.
+ * Under a time budget (see analyze_case), the runs of each job are capped to its share of the cell budget, the jobs are run in a child process if there's a timeout, and the jobs of the cells that timed out or that start after the total budget ran out are skipped.
  */
-SortingInfo* selection_sort(int *array, int size)
+static void* benchmark_worker(void *arg)
 {
-    SortingInfo *info = malloc(sizeof(SortingInfo));
-    info->comparisons_count = info->swaps_count = 0;
-    clock_t starting_clock = clock();
-
-    for(int i = 0; i < size - 1; i++) {
-        int index_min = i;
-        for(int j = i+1; j < size; j++) {
-            info->comparisons_count++;
-            if(array[j] < array[index_min])
-                index_min = j;
+    BenchmarkWorker *worker = arg;
+    BenchmarkQueue *queue = worker->queue;
+    if(worker->pin)
+        pin_to_core(worker->worker_id);
+
+    double max_seconds = (time_budget.cell_seconds > 0) ? time_budget.cell_seconds / queue->num_executions : 0;
+    SortingInfo job_info;
+    init_sorting_info(&job_info);
+    while(true) {
+        pthread_mutex_lock(&queue->lock);
+        if(queue->next_job >= queue->num_jobs) {
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        BenchmarkJob *job = &queue->jobs[queue->next_job++];
+        const char *name = ALGORITHMS[job->alg_index].name;
+        int cell = job->alg_index * queue->results->num_sizes + job->size_index;
+        bool skip = queue->results->status[cell].state != CELL_MEASURED;
+        if(!skip && remaining_budget() <= 0) {
+            queue->results->status[cell].state = CELL_SKIPPED;
+            queue->results->status[cell].predicted_time = 0;
+            printf("\t\t-> [Size %zu | Execution %d/%d] %s... SKIPPED (the time budget ran out)\n", job->size, job->execution + 1, queue->num_executions, name);
+            skip = true;
+        }
+        pthread_mutex_unlock(&queue->lock);
+        if(skip)
+            continue;
+
+        bool sorted = true;
+        int outcome = JOB_DONE;
+        if(time_budget.timeout_seconds > 0)
+            outcome = measure_in_child(queue->type, job->alg_index, job->input, worker->work, job->size, queue->config, max_seconds, &job_info, &sorted);
+        else
+            measure_sort(queue->type, job->alg_index, job->input, worker->work->data, job->size, queue->config, max_seconds, &job_info, &sorted);
+
+        if(!sorted) { //check if the sorting was sucessful
+            printf("\n\nERROR: %s couldn't sort the given array. The array isn't sorted correctly%s. Aborting...\n", name, (get_algorithm_properties(job->alg_index) & SORT_STABLE) ? " (or the order of equal elements changed)" : "");
+            exit(1);
         }
 
-        if(index_min != i) {
-            swap(&array[i], &array[index_min]);
-            info->swaps_count++;
+        pthread_mutex_lock(&queue->lock);
+        if(outcome == JOB_TIMED_OUT) {
+            queue->results->status[cell].state = CELL_TIMED_OUT;
+            queue->results->status[cell].predicted_time = time_budget.timeout_seconds;
+            printf("\t\t-> [Size %zu | Execution %d/%d] %s... TIMED OUT (a sort took more than %.2lfs)\n", job->size, job->execution + 1, queue->num_executions, name, time_budget.timeout_seconds);
+        }
+        else if(queue->results->status[cell].state == CELL_MEASURED) {
+            printf("\t\t-> [Size %zu | Execution %d/%d] %s... OK! (%.6lfs | instrumented: %.6lfs)\n", job->size, job->execution + 1, queue->num_executions, name, job_info.time, job_info.instrumented_time);
+            if(queue->writer != NULL)
+                results_writer_write(queue->writer, ALGORITHMS[job->alg_index].id, queue->type->id, queue->case_id, job->size, job->execution, &job_info);
+            sum_info(&queue->results->cells[cell], &job_info);
         }
+        fflush(stdout);
+        pthread_mutex_unlock(&queue->lock);
     }
 
-    info->time = ( (double) (clock() - starting_clock) ) / CLOCKS_PER_SEC;
-    return info;
+    samples_free(&job_info.samples);
+    perf_counters_close();
+    return NULL;
 }
 
 /*
- * Gapped insertion sort algorithm. Return a tuple containing, respectively, the number of comparisons and the number of swaps made.
+ * Bytes taken by an input of "size" elements of "elem_size" bytes in the inputs buffer of analyze_case, rounded up so that the next input stays aligned to BUFFER_ALIGNMENT. SIZE_MAX if it overflows.
  */
-static long long int* gapped_insertion_sort(int *array, int size, int gap)
+static size_t input_stride(size_t size, size_t elem_size) {
+    if(size > (SIZE_MAX - BUFFER_ALIGNMENT) / elem_size)
+        return SIZE_MAX;
+    return (size * elem_size + BUFFER_ALIGNMENT - 1) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+}
+
+/*
+ * Generates (or loads from the dataset cache) the "num_executions" inputs of sizes[size_index], starting at "inputs", and adds a job for each of them and each algorithm with run[algorithm] set. Nothing is generated if no algorithm runs.
+ */
+static void queue_size_jobs(BenchmarkQueue *queue, int array_case, const size_t *sizes, int size_index, char *inputs, const bool *run)
 {
-    long long int *info = calloc(2, sizeof(long long int));
-    for(int i = gap; i < size; i++) {
-        for(int j = i; (j - gap) >= 0; j -= gap) {
-            info[0]++;
-            if(array[j] < array[j-gap]) {
-                swap(&array[j], &array[j-gap]);
-                info[1]++;
-            }
-            else
-                break;
+    const ElementType *type = queue->type;
+    size_t size = sizes[size_index], stride = input_stride(size, type->elem_size);
+    bool any = false;
+    for(int a = 0; a < queue->results->num_algorithms; a++)
+        any = any || run[a];
+    if(!any)
+        return;
+
+    int num_cached = 0;
+    for(int n = 0; n < queue->num_executions; n++) {
+        void *input = inputs + n*stride;
+        num_cached += load_dataset(type->id, type->elem_size, array_case, size, n, input, type->generate);
+        for(int a = 0; a < queue->results->num_algorithms; a++) {
+            if(run[a])
+                queue->jobs[queue->num_jobs++] = (BenchmarkJob) {a, size_index, n, input, size};
         }
     }
+    if(get_dataset_cache_dir() != NULL)
+        printf("\t-> Size %zu: %d of %d input(s) loaded from the dataset cache\n", size, num_cached, queue->num_executions);
+}
 
-    return info;
+/*
+ * Returns true if the jobs of the given algorithm must run alone (see run_jobs): the ones of the multithreaded algorithms (SORT_PARALLEL), except shellsort when its h-sorts aren't split among threads.
+ */
+static bool runs_alone(int algorithm) {
+    if(!(get_algorithm_properties(algorithm) & SORT_PARALLEL))
+        return false;
+    return strcmp(ALGORITHMS[algorithm].id, "shellsort") != 0 || shellsort_threads != 1;
 }
 
 /*
- * Insertion sort algorithm.
+ * Runs the jobs queue->jobs[first_job...end_job-1] on "num_workers" threads (worker w uses the work buffer work[w]).
  */
-SortingInfo* insertion_sort(int *array, int size)
+static void run_workers(BenchmarkQueue *queue, int first_job, int end_job, Buffer *work, int num_workers, bool pin_workers)
 {
-    SortingInfo *info = malloc(sizeof(SortingInfo));
-    clock_t starting_clock = clock();
+    queue->next_job = first_job;
+    queue->num_jobs = end_job;
+    pthread_t *threads = malloc(num_workers * sizeof(pthread_t));  assert(threads != NULL);
+    BenchmarkWorker *workers = malloc(num_workers * sizeof(BenchmarkWorker));  assert(workers != NULL);
+    for(int w = 0; w < num_workers; w++) {
+        workers[w] = (BenchmarkWorker) {queue, w, pin_workers, &work[w]};
+        int error = pthread_create(&threads[w], NULL, &benchmark_worker, &workers[w]);  assert(error == 0);
+    }
+    for(int w = 0; w < num_workers; w++)
+        pthread_join(threads[w], NULL);
+    free(threads);  free(workers);
+}
 
-    long long int *temp_info = gapped_insertion_sort(array, size, 1); //gapped insertion sort with a gap of 1 (equivalent to the regular insertion sort)
-    info->comparisons_count = temp_info[0];
-    info->swaps_count = temp_info[1];
-    free(temp_info);
+/*
+ * Runs the jobs of the queue and empties it. The jobs of the multithreaded algorithms (see runs_alone) run after the others, on a single unpinned worker, so that their threads don't compete for the cores with other workers (the threads created by a pinned worker would also inherit its core). The other jobs run on "num_workers" threads, in the order they were queued.
+ */
+static void run_jobs(BenchmarkQueue *queue, Buffer *work, int num_workers, bool pin_workers)
+{
+    int num_jobs = queue->num_jobs, num_shared = 0;
+    BenchmarkJob *reordered = malloc(num_jobs * sizeof(BenchmarkJob));  assert(reordered != NULL);
+    for(int j = 0; j < num_jobs; j++) {
+        if(!runs_alone(queue->jobs[j].alg_index))
+            reordered[num_shared++] = queue->jobs[j];
+    }
+    for(int j = 0, n = num_shared; j < num_jobs; j++) {
+        if(runs_alone(queue->jobs[j].alg_index))
+            reordered[n++] = queue->jobs[j];
+    }
+    memcpy(queue->jobs, reordered, num_jobs * sizeof(BenchmarkJob));
+    free(reordered);
 
-    info->time = ( (double) (clock() - starting_clock) ) / CLOCKS_PER_SEC;
-    return info;
+    if(num_shared > 0) {
+        printf("\t-> Running %d jobs on %d worker(s)\n", num_shared, num_workers);
+        run_workers(queue, 0, num_shared, work, num_workers, pin_workers);
+    }
+    if(num_jobs > num_shared) {
+        printf("\t-> Running %d jobs of the multithreaded algorithms alone\n", num_jobs - num_shared);
+        run_workers(queue, num_shared, num_jobs, work, 1, false);
+    }
+    queue->num_jobs = queue->next_job = 0;
+}
 
-    //REGULAR INSERTION SORT
-    /*for(int i = 1; i < size; i++) {
-        for(int j = i; j > 0; j--) {
-            info->comparisons_count++;
-            if(array[j] < array[j-1]) {
-                swap(&array[j], &array[j-1]);
-                info->swaps_count++;
-            }
-            else
-                break;
-        }
-    }*/
+static double n_log_n(double n) {
+    return n * log2(n + 1);
 }
 
 /*
- * Returns true if the given array is a max heap. Used only for debugging.
+ * Predicts the time of one sort of sizes[order[o]] elements by the given algorithm from its results on the smaller sizes, which run before it (order[o+1...num_sizes-1], see analyze_case). A cell that timed out counts as sorts taking the timeout (a lower bound). Returns -1 if there's nothing to predict from.
+ * With a single smaller size, its time is scaled by n log n (the least that a comparison sort grows). With more, it's scaled by the power law fitted to the closest 3 of them (see fit_power_law), whose exponent is clamped to [1, 3] so that the noise of the small sizes doesn't make it absurd.
  */
-static bool is_max_heap(int *array, int size) 
+static double predict_sort_time(CaseResults *results, int algorithm, const size_t *sizes, const int *order, int o)
 {
-    for(int i = 0; i < (size - 1)/2; i++) {
-        if(array[i] < array[2*i + 1] || ((2*i + 2) < size && array[i] < array[2*i + 2]))
-            return false;
+    double x[3], y[3];
+    int n = 0;
+    for(int p = o + 1; p < results->num_sizes && n < 3; p++) {
+        double predicted;
+        int state = get_case_result_state(results, algorithm, order[p], &predicted);
+        double time = (state == CELL_TIMED_OUT) ? predicted : get_execution_time(get_case_result(results, algorithm, order[p]));
+        if(state != CELL_SKIPPED && time > 0 && sizes[order[p]] < sizes[order[o]]) {
+            x[n] = sizes[order[p]];
+            y[n++] = time;
+        }
     }
-
-    return true;
+    if(n == 0)
+        return -1;
+
+    double size = sizes[order[o]];
+    PowerLaw law = fit_power_law(x, y, n);
+    if(isnan(law.exponent))
+        return y[0] * n_log_n(size) / n_log_n(x[0]);
+    return y[0] * pow(size / x[0], fmin(fmax(law.exponent, 1), 3));
 }
 
 /*
- * Assuming that the given array is almost a heap, except for maybe the item in index i (meaning it might have a lower value than its childs), this function will turn the array into a heap (if necessary).
- * Returns a 2d tuple containing, respectively, the number of comparisons and the number of swaps made.
+ * Decides whether the given algorithm runs on sizes[order[o]] under the time budget. It doesn't if the total budget ran out, if it was skipped on the next smaller size or if the predicted time of its cheapest run (one measured and one instrumented sort of each input; the statistics mode is capped by measure_sort) exceeds the cell budget or what's left of the total budget, or a sort is predicted to exceed the timeout.
+ * Skipped cells are marked as such, with their predicted time (0 if the total budget ran out). A cell skipped after a skipped one, which leaves nothing to predict from, gets the prediction of that one scaled by n log n.
  */
-static long long int* max_heapify(int *array, int size, int i)
+static bool fits_time_budget(CaseResults *results, int algorithm, const size_t *sizes, const int *order, int o, int num_executions)
 {
-    long long int *info = calloc(2, sizeof(long long int));
-    while(i < size) {
-        int temp_index = i, 
-            left_child = 2*i + 1, 
-            right_child = 2*i + 2;
+    int cell = algorithm * results->num_sizes + order[o];
+    double sort_time = predict_sort_time(results, algorithm, sizes, order, o), previous = 0;
+    bool skipped_before = o + 1 < results->num_sizes && get_case_result_state(results, algorithm, order[o + 1], &previous) == CELL_SKIPPED;
+    if(remaining_budget() <= 0) {
+        results->status[cell].state = CELL_SKIPPED;
+        results->status[cell].predicted_time = 0;
+        printf("\t-> Skipping %s on size %zu (the time budget ran out)\n", ALGORITHMS[algorithm].name, sizes[order[o]]);
+        return false;
+    }
+    if(sort_time < 0 && !skipped_before)
+        return true;
+
+    double cell_time = (sort_time >= 0) ? 2 * num_executions * sort_time : previous * n_log_n(sizes[order[o]]) / n_log_n(sizes[order[o + 1]]);
+    bool fits = !skipped_before && (time_budget.timeout_seconds <= 0 || sort_time <= time_budget.timeout_seconds)
+                && (time_budget.cell_seconds <= 0 || cell_time <= time_budget.cell_seconds) && cell_time <= remaining_budget();
+    if(!fits) {
+        results->status[cell].state = CELL_SKIPPED;
+        results->status[cell].predicted_time = cell_time;
+        if(cell_time > 0)
+            printf("\t-> Skipping %s on size %zu (predicted %.2lfs)\n", ALGORITHMS[algorithm].name, sizes[order[o]], cell_time);
+        else
+            printf("\t-> Skipping %s on size %zu (the time budget ran out)\n", ALGORITHMS[algorithm].name, sizes[order[o]]);
+    }
+    return fits;
+}
 
-        //checks whether the element at i is greater than its left child
-        if(left_child < size && array[temp_index] < array[left_child]) 
-            temp_index = left_child;
+/* 
+ * Run the selected algorithms ("selected[i]" is true if the algorithm with index i should be run, or NULL to run all of them) "num_executions" times on arrays of the given element type and case, with each of the given sizes. The algorithms that aren't built for the element type are skipped.
+ * Each input is sorted by both versions of each algorithm (zero-overhead and instrumented). Every (algorithm, size, execution) job is independent, so they're distributed among "num_workers" threads (all the cores if num_workers < 1), except the ones of the multithreaded algorithms, which run alone (see run_jobs). The algorithms of an execution all sort copies of the same input. If "pin_workers" is true, each worker is pinned to a different core.
+ * If "config" isn't NULL, the statistics mode is used (see measure_sort).
+ * If "writer" isn't NULL, the record of each (algorithm, size, execution) is written to it, labeled with the ids of the element type and of the case, as soon as it's measured.
+ * All the inputs live in a single buffer, allocated and prefaulted before any job starts (see alloc_buffer), along with a work buffer for each worker, big enough for the largest size. If they don't fit into memory, the largest sizes are skipped (with a warning) until they do.
+ * Without a time budget (see set_time_budget), the jobs of all the sizes run at once, the largest sizes first, so that the slowest jobs don't end up running alone at the end. With one, the sizes run one at a time, in ascending order, and each algorithm only runs on a size if its time, predicted from the smaller sizes, fits the budget (see fits_time_budget).
+ * Returns the matrix with the mean performance and the time samples of each algorithm on each size (see get_case_result). The cells of the algorithms and sizes that weren't run are empty, and the ones of the sizes skipped for lack of memory are marked CELL_NO_MEMORY.
+ */
+CaseResults* analyze_case(int type, int array_case, const size_t *sizes, int num_sizes, const bool *selected, int num_executions, int num_workers, bool pin_workers, const StatisticsConfig *config,
+                          ResultsWriter *writer)
+{
+    const ElementType *element_type = &ELEMENT_TYPES[type];
+
+    //allocating the results matrix, with room for the samples of all the executions of the algorithms that will run
+    CaseResults *results = malloc(sizeof(CaseResults));  assert(results != NULL);
+    results->num_algorithms = num_algorithms;
+    results->num_sizes = num_sizes;
+    results->cells = malloc(num_algorithms * num_sizes * sizeof(SortingInfo));  assert(results->cells != NULL);
+    results->status = calloc(num_algorithms * num_sizes, sizeof(*results->status));  assert(results->status != NULL);
+    int runs_per_input = (config == NULL) ? 1 : (config->max_runs > 0 ? config->max_runs : config->min_runs);
+    for(int i = 0; i < num_algorithms * num_sizes; i++) {
+        int a = i / num_sizes;
+        init_sorting_info(&results->cells[i]);
+        if((selected == NULL || selected[a]) && is_algorithm_available(type, a))
+            samples_reserve(&results->cells[i].samples, num_executions * runs_per_input);
+    }
 
-        //checks whether the element at i is greater than its right child
-        if(right_child < size && array[temp_index] < array[right_child]) 
-            temp_index = right_child;
+    //sorting the sizes in descending order
+    int *order = malloc(num_sizes * sizeof(int));  assert(order != NULL);
+    for(int i = 0; i < num_sizes; i++) {
+        int j = i;
+        for(; j > 0 && sizes[order[j-1]] < sizes[i]; j--)
+            order[j] = order[j-1];
+        order[j] = i;
+    }
 
-        info[0] += 3; //3 comparions were made
-        if(temp_index == i)
-            //break if the element at i is greater than its childs, that is, if the heap property was reestablished
+    if(num_workers < 1)
+        num_workers = get_num_cores();
+
+    //allocating the inputs buffer (the inputs of the size with index i start at offsets[i]) and the work buffers of the workers, without the largest sizes if they don't fit
+    size_t *offsets = malloc(num_sizes * sizeof(size_t));  assert(offsets != NULL);
+    Buffer inputs, *work = calloc(num_workers, sizeof(Buffer));  assert(work != NULL);
+    int first_size = 0; //sizes order[0...first_size-1] are skipped
+    while(true) {
+        size_t total = 0;
+        for(int o = first_size; o < num_sizes; o++) {
+            size_t stride = input_stride(sizes[order[o]], element_type->elem_size);
+            offsets[order[o]] = total;
+            total = (stride == SIZE_MAX || total == SIZE_MAX || stride > (SIZE_MAX - total) / num_executions) ? SIZE_MAX : total + stride * num_executions;
+        }
+        size_t largest = (first_size < num_sizes) ? sizes[order[first_size]] : 0;
+        int w = 0;
+        if(alloc_buffer(&inputs, total, 1)) {
+            while(w < num_workers && alloc_buffer(&work[w], largest, element_type->elem_size))
+                w++;
+        }
+        if(w == num_workers || first_size == num_sizes)
             break;
+        while(w > 0)
+            free_buffer(&work[--w]);
+        free_buffer(&inputs);
+        printf("\t-> WARNING: not enough memory for the arrays of size %zu, skipping it\n", sizes[order[first_size]]);
+        for(int a = 0; a < num_algorithms; a++)
+            results->status[a * num_sizes + order[first_size]].state = CELL_NO_MEMORY;
+        first_size++;
+    }
 
-        swap(&array[temp_index], &array[i]); //swap the element at i with its left or right child (whichever one has the greatest value)
-        info[1]++;
-        i = temp_index;
+    //generating (or loading from the dataset cache) the shared inputs and running the jobs
+    BenchmarkQueue queue = {.num_jobs = 0, .next_job = 0, .num_executions = num_executions, .config = config, .results = results,
+                            .type = element_type, .case_id = get_case_id(array_case), .writer = writer};
+    queue.jobs = malloc(num_sizes * num_executions * num_algorithms * sizeof(BenchmarkJob));  assert(queue.jobs != NULL);
+    pthread_mutex_init(&queue.lock, NULL);
+
+    bool *run = malloc(num_algorithms * sizeof(bool));  assert(run != NULL);
+    for(int a = 0; a < num_algorithms; a++)
+        run[a] = (selected == NULL || selected[a]) && is_algorithm_available(type, a);
+
+    if(!has_time_budget()) {
+        for(int o = first_size; o < num_sizes; o++)
+            queue_size_jobs(&queue, array_case, sizes, order[o], (char*) inputs.data + offsets[order[o]], run);
+        run_jobs(&queue, work, num_workers, pin_workers);
+    }
+    else {
+        for(int o = num_sizes - 1; o >= first_size; o--) {
+            bool *run_size = malloc(num_algorithms * sizeof(bool));  assert(run_size != NULL);
+            for(int a = 0; a < num_algorithms; a++)
+                run_size[a] = run[a] && fits_time_budget(results, a, sizes, order, o, num_executions);
+            queue_size_jobs(&queue, array_case, sizes, order[o], (char*) inputs.data + offsets[order[o]], run_size);
+            run_jobs(&queue, work, num_workers, pin_workers);
+
+            //the mean of this size is needed to predict the next one
+            for(int a = 0; a < num_algorithms; a++)
+                divide_info(get_case_result(results, a, order[o]), num_executions);
+            free(run_size);
+        }
     }
 
-    return info;
+    //mean of the performance for each array size
+    for(int i = 0; i < num_algorithms * num_sizes && !has_time_budget(); i++)
+        divide_info(&results->cells[i], num_executions);
+
+    //freeing memory
+    free_buffer(&inputs);
+    for(int w = 0; w < num_workers; w++)
+        free_buffer(&work[w]);
+    free(offsets);  free(work);  free(order);  free(queue.jobs);  free(run);
+    pthread_mutex_destroy(&queue.lock);
+
+    return results;
+}
+
+/* 
+ * Run all the algorithms "num_executions" times on int arrays of the given case, with sizes going from 10^min_size_exp to 10^max_size_exp (see analyze_case).
+ * Algorithms indexes: bubble_sort[0], flagged_bubble_sort[1], selection_sort[2], insertion_sort[3], heapsort[4], shellsort[5], quicksort[6], merge_sort[7], introsort[8], timsort[9], merge_sort_top_down[10],
+ *                     merge_sort_bottom_up[11], parallel_quicksort[12], lsd_radix_sort[13], lsd_radix_sort_11bit[14], msd_radix_sort[15], quicksort_network[16], merge_sort_network[17],
+ *                     followed by the plugins (in the order they were registered).
+ */
+CaseResults* analyze_case_on_all(int array_case, int min_size_exp, int max_size_exp, int num_executions, int num_workers, bool pin_workers, const StatisticsConfig *config)
+{
+    int num_sizes = max_size_exp - min_size_exp + 1; //number of different array sizes
+    size_t *sizes = malloc(num_sizes * sizeof(size_t));  assert(sizes != NULL);
+    for(int k = min_size_exp; k <= max_size_exp; k++)
+        sizes[k - min_size_exp] = (size_t) pow(10, k);
+
+    CaseResults *results = analyze_case(INT_ELEMENTS, array_case, sizes, num_sizes, NULL, num_executions, num_workers, pin_workers, config, NULL);
+    free(sizes);
+    return results;
 }
 
 /*
- * Builds (in-place) a max heap out of the given array.
- * Returns a 2d tuple containing, respectively, the number of comparisons and the number of swaps made.
+ * Returns the results of the given algorithm on the size with the given index (its position in the sizes given to analyze_case).
  */
-static long long int* build_max_heap(int *array, int size)
+SortingInfo* get_case_result(CaseResults *results, int algorithm, int size_index) {
+    return &results->cells[algorithm * results->num_sizes + size_index];
+}
+
+/*
+ * Returns the state of a cell of the results matrix (CELL_MEASURED, CELL_SKIPPED, CELL_TIMED_OUT or CELL_NO_MEMORY). If "predicted_time" isn't NULL, the predicted time of a skipped cell (0 if the total budget ran out) or the timeout of a cell that timed out is written to it.
+ */
+int get_case_result_state(CaseResults *results, int algorithm, int size_index, double *predicted_time)
 {
-    long long int *info = calloc(2, sizeof(long long int));
-    for(int i = size/2 - 1; i >= 0; i--) {
-        long long int *temp_info = max_heapify(array, size, i);
-        info[0] += temp_info[0];
-        info[1] += temp_info[1];
-        free(temp_info);
-    }
+    int cell = algorithm * results->num_sizes + size_index;
+    if(predicted_time != NULL)
+        *predicted_time = results->status[cell].predicted_time;
+    return results->status[cell].state;
+}
 
-    return info;
+/*
+ * Frees a matrix returned by analyze_case.
+ */
+void free_case_results(CaseResults *results)
+{
+    for(int i = 0; i < results->num_algorithms * results->num_sizes; i++)
+        samples_free(&results->cells[i].samples);
+    free(results->cells);  free(results->status);
+    free(results);
 }
 
 /*
- * Heapsort algorithm.
+ * Write the current date and time to the given .txt file.
  */
-SortingInfo* heapsort(int *array, int size) 
+void time_now_to_file(FILE *file) {
+    time_t raw_time; time(&raw_time);
+    struct tm time_info = *localtime(&raw_time);
+    fprintf(file, "Date and time of execution: %d/%d/%d %d:%d:%d\n", time_info.tm_year + 1900, time_info.tm_mon + 1, time_info.tm_mday, time_info.tm_hour, time_info.tm_min, time_info.tm_sec);
+}
+
+/*
+ * Print to a file (fprintf) the performance of an algorithm on all the array sizes of the given results of a case.
+ */
+void fprint_case(FILE *file, CaseResults *results, int algorithm, const size_t *sizes)
 {
-    SortingInfo *info = malloc(sizeof(SortingInfo));
-    info->comparisons_count = info->swaps_count = 0;
-    clock_t starting_clock = clock();
+    for(int j = 0; j < results->num_sizes; j++) {
+        SortingInfo *info = get_case_result(results, algorithm, j);
+        double predicted;
+        int state = get_case_result_state(results, algorithm, j, &predicted);
+        if(state == CELL_SKIPPED && predicted > 0)
+            fprintf(file, "\t< SIZE: %zu (%.0e)  |  SKIPPED (predicted %.2lfs) >\n", sizes[j], (double) sizes[j], predicted);
+        else if(state == CELL_SKIPPED)
+            fprintf(file, "\t< SIZE: %zu (%.0e)  |  SKIPPED (the time budget ran out) >\n", sizes[j], (double) sizes[j]);
+        else if(state == CELL_TIMED_OUT)
+            fprintf(file, "\t< SIZE: %zu (%.0e)  |  TIMED OUT (a sort took more than %.2lfs) >\n", sizes[j], (double) sizes[j], predicted);
+        else if(state == CELL_NO_MEMORY)
+            fprintf(file, "\t< SIZE: %zu (%.0e)  |  SKIPPED (not enough memory for the arrays) >\n", sizes[j], (double) sizes[j]);
+        if(state != CELL_MEASURED)
+            continue;
+
+        fprintf(file, "\t< SIZE: %zu (%.0e)  |  TIME: %.8lfs  |  INSTRUMENTED TIME: %.8lfs  |  COMPARISONS: %lld  |  SWAPS: %lld >\n", 
+            sizes[j], (double) sizes[j], get_execution_time(info), get_instrumented_time(info), get_comparisons_count(info), get_swaps_count(info));
+        fprintf(file, "\t\t");
+        fprint_hw_counters(file, info);
+        fprintf(file, "\n\t\t");
+        fprint_time_statistics(file, info);
+        fprintf(file, "\n");
+    }
+}
 
-    build_max_heap(array, size);
-    for(int i = size - 1; i > 0; i--) {
-        swap(&array[0], &array[i]); //the greatest element of the heap is in its first position!
-        long long int *temp_info = max_heapify(array, i, 0);
+/*
+ * Prints (fprintf) the properties of an algorithm, e.g. "stable, in-place", or "none".
+ */
+void fprint_algorithm_properties(FILE *file, int index)
+{
+    const char *names[] = {"stable", "in-place", "parallel"};
+    unsigned int flags[] = {SORT_STABLE, SORT_IN_PLACE, SORT_PARALLEL};
 
-        info->comparisons_count += temp_info[0];
-        info->swaps_count += temp_info[1];
-        free(temp_info);
+    int printed = 0;
+    for(int i = 0; i < 3; i++) {
+        if(ALGORITHMS[index].properties & flags[i])
+            fprintf(file, "%s%s", (printed++ > 0) ? ", " : "", names[i]);
     }
+    if(printed == 0)
+        fprintf(file, "none");
+}
 
-    info->time = ( (double) (clock() - starting_clock) ) / CLOCKS_PER_SEC;
-    return info;
+/*
+ * Prints (fprintf) the hardware counters of the given info, with "n/a" for the ones that couldn't be measured.
+ */
+void fprint_hw_counters(FILE *file, SortingInfo *info)
+{
+    const char *names[] = {"CYCLES", "INSTRUCTIONS", "L1 MISSES", "LLC MISSES", "BRANCH MISSES"};
+    long long int values[] = {info->hw.cycles, info->hw.instructions, info->hw.l1_misses, info->hw.llc_misses, info->hw.branch_misses};
+
+    for(int i = 0; i < 5; i++) {
+        if(values[i] == PERF_COUNTER_UNAVAILABLE)
+            fprintf(file, "%s%s: n/a", (i > 0) ? "  |  " : "", names[i]);
+        else
+            fprintf(file, "%s%s: %lld", (i > 0) ? "  |  " : "", names[i], values[i]);
+    }
 }
 
 /*
- * Shellsort algorithm using the Ciura's gap sequence. All the elements after 701 have been approximated with the recursive formula Hk = 2.25*Hk-1 (obtained from the Tokuda's sequence). This approximations seem to improve the algorithm's performance for very big arrays.
+ * Prints (fprintf) the statistics of the time samples of the given info.
  */
-SortingInfo* shellsort(int *array, int size) 
+void fprint_time_statistics(FILE *file, SortingInfo *info)
 {
-    SortingInfo *info = malloc(sizeof(SortingInfo));
-    info->comparisons_count = info->swaps_count = 0;
-    clock_t starting_clock = clock();
+    TimeStatistics stats = get_time_statistics(info);
+    fprintf(file, "SAMPLES: %d  |  MIN: %.8lfs  |  MEDIAN: %.8lfs  |  P90: %.8lfs  |  P99: %.8lfs  |  MEAN: %.8lfs  |  STDDEV: %.8lfs  |  95%% CI: [%.8lfs, %.8lfs]",
+            stats.num_samples, stats.min, stats.median, stats.p90, stats.p99, stats.mean, stats.stddev, stats.ci_low, stats.ci_high);
+}
 
-    int const GAPS[] = {1, 4, 10, 23, 57, 132, 301, 701, 1577, 3549, 7995, 17965, 40423}; //Ciura's gap sequence (approximation)
-    for(int k = 13; k >= 0; k--) {
-        long long int *temp_info = gapped_insertion_sort(array, size, GAPS[k]);
-        info->comparisons_count += temp_info[0];
-        info->swaps_count += temp_info[1];
-        free(temp_info);
+/*
+ * Save the given sorting informations (one per array case) in the given .txt file.
+ */
+void save_sorting_info(SortingInfo *infos[NUM_CASES], size_t arrays_size, int num_executions, FILE *file)
+{
+    fprintf(file, "\t< ARRAYS SIZE: %zu (%.0e)  |  NUMBER OF EXECUTIONS: %d >\n", arrays_size, (double) arrays_size, num_executions);
+    for(int i = 0; i < NUM_CASES; i++) {
+        fprintf(file, "\t\t[%s]  Time: %.8lfs  |  Instrumented time: %.8lfs  |  Comparisons: %lld  |  Swaps: %lld\n\t\t\t", 
+                get_case_name(i), get_execution_time(infos[i]), get_instrumented_time(infos[i]), get_comparisons_count(infos[i]), get_swaps_count(infos[i]));
+        fprint_hw_counters(file, infos[i]);
+        fprintf(file, "\n\t\t\t");
+        fprint_time_statistics(file, infos[i]);
+        fprintf(file, "\n");
     }
+    fprintf(file, "\n");
+}
 
-    info->time = ( (double) (clock() - starting_clock) ) / CLOCKS_PER_SEC;
-    return info;
+/*
+ * Starts measuring the time and the hardware counters of a kernel. Returns the starting time.
+ */
+static double start_timing(void) {
+    perf_counters_start();
+    return monotonic_time();
 }
 
 /*
- * Partition the given array from start_index to end_index by choosing a random pivot and placing all elements smaller or equal to the pivot to its left and all elements greater than the pivot to its right. Hoare's partitioning method is used here.
- * Return the index of the pivot in the new array.
+ * Stops measuring and stores the hardware counters in "counters". Returns the elapsed (wall clock) time, in seconds.
  */
-static int partition(int *array, int start_index, int end_index, long long int *comparisons_counter, long long int *swaps_counter) 
-{ 
-    //check whether the seed for the rand() function has been set
-    if(!seed_set) {
-        srand(time(NULL));
-        seed_set = true;
+static double stop_timing(double starting_time, SortCounters *counters) {
+    double time = monotonic_time() - starting_time;
+    perf_counters_stop(&counters->hw);
+    return time;
+}
+
+/*
+ * Runs the instrumented or the zero-overhead kernel of an algorithm on an array of the given element type. Returns its time (see measure_sort).
+ * The plugins have a single function per type, which is timed here and only counts the comparisons and swaps when it gets a SortPluginCounters (the instrumented run).
+ */
+static double run_kernel(const ElementType *type, int algorithm, void *array, size_t size, SortCounters *counters, bool instrumented)
+{
+    double time;
+    if(algorithm < NUM_BUILTIN_ALGORITHMS)
+        time = (instrumented ? type->kernels : type->clean_kernels)[algorithm](array, size, counters);
+    else {
+        SortPluginCounters plugin_counters = {0, 0};
+        SortPluginFunction sort = ALGORITHMS[algorithm].plugin_sorts[type - ELEMENT_TYPES];
+        double start = start_timing();
+        sort(array, size, instrumented ? &plugin_counters : NULL);
+        time = stop_timing(start, counters);
+        counters->comparisons = plugin_counters.comparisons;
+        counters->swaps = plugin_counters.swaps;
     }
 
-    //select a random pivot and place it into the end of the sub-array
-    int random_index = start_index + (rand() % (end_index - start_index + 1));
-    swap(&array[end_index], &array[random_index]);
-    (*swaps_counter)++;
+    if(heartbeat_fd >= 0 && write(heartbeat_fd, "h", 1) != 1)
+        _exit(EXIT_FAILURE); //the parent is gone
+    return time;
+}
 
-    //Hoare's partitioning
-    int pivot = array[end_index];
-    int l = start_index - 1, r = end_index;
+/*
+ * Returns true if the given array is a max heap. Used only for debugging.
+ */
+static bool is_max_heap(int *array, size_t size) 
+{
+    for(size_t i = 0; 2*i + 1 < size; i++) {
+        if(array[i] < array[2*i + 1] || ((2*i + 2) < size && array[i] < array[2*i + 2]))
+            return false;
+    }
 
-    while(true) {
-        do { l++; /**/ (*comparisons_counter)++; } while(array[l] <= pivot); //incrementing the left pointer until a "wrong" element is found
-        do { r--; /**/ (*comparisons_counter)++; } while(array[r] > pivot); //decrementing the right pointer until a "wrong" element is found
+    return true;
+}
 
-        //stop if the pointers have met
-        if(l >= r)
-            break;
+#define PARALLEL_QUICKSORT_CUTOFF 8192 //sub-arrays smaller than this are sorted serially by the thread that owns them
+
+/*
+ * Sub-array array[start_index...end_index] waiting to be sorted by parallel_quicksort.
+ */
+typedef struct {
+    ptrdiff_t start_index, end_index;
+} QuicksortTask;
 
-        swap(&array[l], &array[r]); //swap a wrong element in the left with a wrong element in the right, putting them in their right positions
-        (*swaps_counter)++;
+/*
+ * Double-ended queue of tasks of a parallel_quicksort thread. The owner pushes and pops tasks at the tail, while the other threads steal them from the head (the oldest and, usually, the biggest tasks).
+ * The counters are only touched by the owner (and only in the instrumented version).
+ */
+typedef struct {
+    QuicksortTask *tasks;
+    int head, tail, capacity;
+    pthread_mutex_t lock;
+    SortCounters counters;
+} QuicksortDeque;
+
+typedef struct {
+    int *array, num_threads;
+    QuicksortDeque *deques;
+    atomic_long pending_tasks; //tasks that have been pushed but not finished yet
+} QuicksortPool;
+
+typedef struct {
+    QuicksortPool *pool;
+    int thread_id;
+} QuicksortWorker;
+
+static void push_task(QuicksortDeque *deque, QuicksortTask task)
+{
+    pthread_mutex_lock(&deque->lock);
+    if(deque->tail == deque->capacity) {
+        //compacting the deque before growing it
+        memmove(deque->tasks, deque->tasks + deque->head, (deque->tail - deque->head) * sizeof(QuicksortTask));
+        deque->tail -= deque->head;
+        deque->head = 0;
+
+        if(deque->tail == deque->capacity) {
+            deque->capacity *= 2;
+            deque->tasks = realloc(deque->tasks, deque->capacity * sizeof(QuicksortTask));  assert(deque->tasks != NULL);
+        }
     }
 
-    swap(&array[end_index], &array[r + 1]); //swap the pivot with the left-most element of the "right" sub-array (sub-array with elements greater than the pivot)
-    (*swaps_counter)++;
-    
-    return r + 1;
+    deque->tasks[deque->tail++] = task;
+    pthread_mutex_unlock(&deque->lock);
+}
 
-    //Lomuto's partitioning (deprecated)
-    /*int pivot = array[end_index];
-    int i = (start_index - 1);
+/*
+ * Takes a task from the tail (if "steal" is false) or from the head (if "steal" is true) of the deque. Returns false if it's empty.
+ */
+static bool pop_task(QuicksortDeque *deque, QuicksortTask *task, bool steal)
+{
+    bool found = false;
+    pthread_mutex_lock(&deque->lock);
+    if(deque->head < deque->tail) {
+        *task = steal ? deque->tasks[deque->head++] : deque->tasks[--deque->tail];
+        found = true;
+
+        if(deque->head == deque->tail)
+            deque->head = deque->tail = 0;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
 
-    for (int j = start_index; j <= end_index - 1; j++) {  
-        (*comparisons_counter)++;
-        if (array[j] < pivot) { 
-            i++;
-            swap(&array[i], &array[j]); 
-            (*swaps_counter)++;
-        } 
-    } 
+/*
+ * Sets the number of threads used by parallel_quicksort. If it's lower than 1, all the cores are used.
+ */
+void set_parallel_quicksort_threads(int num_threads) {
+    parallel_quicksort_threads = num_threads;
+}
+
+/*
+ * Sets the size of the sub-arrays sorted by a network in quicksort_network and merge_sort_network. It's clamped to [2, SORTING_NETWORK_MAX].
+ */
+void set_network_leaf_size(int size) {
+    network_leaf_size = (size < 2) ? 2 : (size > SORTING_NETWORK_MAX ? SORTING_NETWORK_MAX : size);
+}
 
-    swap(&array[i + 1], &array[end_index]); 
-    (*swaps_counter)++;
-    return (i + 1); */
-} 
+int get_network_leaf_size(void) {return network_leaf_size;}
 
 /*
- * Quicksort algorithm used internally.
+ * Selects the heap used by heapsort (for all element types, and by the heapsort fallback of introsort): its arity (2, 4 or 8), whether the elements are sifted bottom-up (Floyd's method) and whether the grandchildren of each visited node are prefetched. Returns false (and keeps the current heap) if the arity isn't supported.
+ * Not thread-safe: must be called before any sort starts.
  */
-static void quicksort_aux(int *array, int start_index, int end_index, long long int *comparisons_counter, long long int *swaps_counter) 
+bool set_heap_variant(HeapVariant variant)
 {
-    (*comparisons_counter)++;
-    if (start_index < end_index) { 
-        int p = partition(array, start_index, end_index, comparisons_counter, swaps_counter); //pivot
+    if(variant.arity != 2 && variant.arity != 4 && variant.arity != 8)
+        return false;
 
-        quicksort_aux(array, start_index, (p - 1), comparisons_counter, swaps_counter); //sort the array to the left of the pivot
-        quicksort_aux(array, (p + 1), end_index, comparisons_counter, swaps_counter); //sort the array to the right of the pivot
-    } 
+    heap_variant = variant;
+    heap_log_arity = (variant.arity == 2) ? 1 : (variant.arity == 4 ? 2 : 3);
+    return true;
 }
 
+HeapVariant get_heap_variant(void) {return heap_variant;}
+
+#define CACHE_LINE_SIZE 64 //bytes prefetched at a time by __builtin_prefetch on x86-64 and most of arm64 systems
+
+#define SHELLSORT_MAX_GAPS 2048 //enough for the Pratt's sequence of any 64-bit size
+#define SHELLSORT_MIN_CHAINS 64 //h-sorts are split among threads only if each thread gets at least this many chains
+
+static const char *GAP_SEQUENCE_IDS[NUM_GAP_SEQUENCES] = {"ciura", "tokuda", "sedgewick", "pratt"};
+
 /*
- * Wrapper for the quicksort_aux function.
+ * Sets the gap sequence of shellsort (for all element types). Not thread-safe: must be called before any sort starts.
  */
-SortingInfo* quicksort(int *array, int size) 
+void set_shellsort_gaps(int sequence) {shellsort_gap_sequence = sequence;}
+int get_shellsort_gaps(void) {return shellsort_gap_sequence;}
+const char* get_gap_sequence_id(int sequence) {return GAP_SEQUENCE_IDS[sequence];}
+
+/*
+ * Returns the gap sequence with the given id or -1 if there's no such sequence.
+ */
+int find_gap_sequence(const char *id)
 {
-    SortingInfo *info = malloc(sizeof(SortingInfo));
-    clock_t starting_clock = clock();
+    for(int i = 0; i < NUM_GAP_SEQUENCES; i++) {
+        if(strcmp(GAP_SEQUENCE_IDS[i], id) == 0)
+            return i;
+    }
+    return -1;
+}
 
-    long long int comparisons_counter, swaps_counter;
-    comparisons_counter = swaps_counter = 0;
-    
-    quicksort_aux(array, 0, size-1, &comparisons_counter, &swaps_counter);
+/*
+ * Sets the number of threads used by the h-sorts of shellsort (1 by default). If it's lower than 1, all the cores are used.
+ */
+void set_shellsort_threads(int num_threads) {shellsort_threads = num_threads;}
+int get_shellsort_threads(void) {return shellsort_threads;}
 
-    info->comparisons_count = comparisons_counter;
-    info->swaps_count = swaps_counter;
+static int compare_gaps(const void *a, const void *b) {
+    size_t x = *(const size_t*) a, y = *(const size_t*) b;
+    return (x > y) - (x < y);
+}
 
-    info->time = ( (double) (clock() - starting_clock) ) / CLOCKS_PER_SEC;
-    return info;
+/*
+ * Writes the gaps of the selected sequence that are lower than "size" (and at least the gap 1) to "gaps", in increasing order. Returns the number of gaps.
+ *  - ciura: Ciura's sequence up to 701, extended with h(k) = 2.25 * h(k-1);
+ *  - tokuda: h(k) = ceil(h'(k)), with h'(1) = 1 and h'(k) = 2.25 * h'(k-1) + 1;
+ *  - sedgewick: 1, then 4^k + 3 * 2^(k-1) + 1 (Sedgewick, 1986);
+ *  - pratt: all the numbers 2^p * 3^q (O(n log^2 n) comparisons, but many passes).
+ */
+static int shellsort_gaps(size_t size, size_t gaps[SHELLSORT_MAX_GAPS])
+{
+    static const size_t CIURA[] = {1, 4, 10, 23, 57, 132, 301, 701};
+    int n = 0;
+    gaps[n++] = 1;
+
+    if(shellsort_gap_sequence == CIURA_GAPS) {
+        for(int i = 1; i < 8 && CIURA[i] < size; i++)
+            gaps[n++] = CIURA[i];
+        if(n == 8) {
+            for(double h = 2.25 * CIURA[7]; h < size && n < SHELLSORT_MAX_GAPS; h *= 2.25)
+                gaps[n++] = (size_t) h;
+        }
+    }
+    else if(shellsort_gap_sequence == TOKUDA_GAPS) {
+        for(double h = 2.25 + 1; ceil(h) < size && n < SHELLSORT_MAX_GAPS; h = 2.25 * h + 1)
+            gaps[n++] = (size_t) ceil(h);
+    }
+    else if(shellsort_gap_sequence == SEDGEWICK_GAPS) {
+        for(int k = 1; k < 32; k++) {
+            size_t h = ((size_t) 1 << (2*k)) + 3 * ((size_t) 1 << (k - 1)) + 1;
+            if(h >= size)
+                break;
+            gaps[n++] = h;
+        }
+    }
+    else {
+        for(size_t p = 1; p < size; p *= 2) {
+            for(size_t h = p; h < size && n < SHELLSORT_MAX_GAPS; h *= 3) {
+                if(h > 1)
+                    gaps[n++] = h;
+                if(h > SIZE_MAX / 3)
+                    break;
+            }
+            if(p > SIZE_MAX / 2)
+                break;
+        }
+        qsort(gaps, n, sizeof(size_t), &compare_gaps);
+    }
+    return n;
 }
 
 /*
- * Merge array[l...m] and array[m+1...r] assuming that they are both sorted. 
+ * Returns the number of threads among which the h-sort of the given gap is split: up to "num_threads", as long as each one gets at least SHELLSORT_MIN_CHAINS chains (1 means that it isn't split).
  */
-static void merge(int *array, int l, int m, int r, long long int *comparisons_counter, long long int *swaps_counter) 
+static int shellsort_gap_threads(size_t gap, int num_threads)
 {
-    int size_left = m - l + 1, 
-        size_right = r - m;
+    size_t max_threads = gap / SHELLSORT_MIN_CHAINS;
+    return (num_threads > 1 && max_threads < (size_t) num_threads) ? (int) max_threads : num_threads;
+}
 
-    //alocating memory for the temporary arrays and copying the elements into them
-    int *left_array = malloc(size_left * sizeof(int)),
-        *right_array = malloc(size_right * sizeof(int));
+static const char *PARTITION_IDS[NUM_PARTITIONS] = {"hoare", "block", "lomuto"};
 
-    for(int i = 0; i < size_left; i++) { left_array[i] = array[l + i]; } 
-    for(int i = 0; i < size_right; i++) { right_array[i] = array[m + 1 + i]; }
+/*
+ * Sets the partitioning method used by quicksort, parallel_quicksort and quicksort_network (for all element types). Not thread-safe: must be called before any sort starts.
+ */
+void set_quicksort_partition(int partition) {quicksort_partition = partition;}
+int get_quicksort_partition(void) {return quicksort_partition;}
+const char* get_partition_id(int partition) {return PARTITION_IDS[partition];}
 
-    //merging
-    int i = 0, //current index of the left array
-        j = 0, //current index of the right array
-        k = l; //current index of the merged array
+/*
+ * Returns the partitioning method with the given id or -1 if there's no such method.
+ */
+int find_partition(const char *id)
+{
+    for(int i = 0; i < NUM_PARTITIONS; i++) {
+        if(strcmp(PARTITION_IDS[i], id) == 0)
+            return i;
+    }
+    return -1;
+}
 
-    while(i < size_left || j < size_right) { //repeat until both sub-arrays have been fully read
-        //both sub-arrays havent been fully read
-        if(i < size_left && j < size_right) {
-            array[k] = (left_array[i] < right_array[j]) ? left_array[i++] : right_array[j++];
-            (*comparisons_counter)++;
-        }
-        //one of the sub-arrays have been fully read
-        else {
-            array[k] = (i < size_left) ? left_array[i++] : right_array[j++];
-        }
+#define TIMSORT_MIN_MERGE 64 //arrays shorter than this are sorted by binary insertion sort alone in timsort
+#define TIMSORT_MIN_GALLOP 7 //initial number of wins in a row that make a timsort merge start galloping
+#define TIMSORT_MAX_RUNS 85 //maximum size of the run stack of timsort (enough for any 64-bit size)
 
-        k++;
-        (*swaps_counter)++;
+/*
+ * Minimum length of the runs of timsort: a number between TIMSORT_MIN_MERGE/2 and TIMSORT_MIN_MERGE such that size/minrun is a power of 2 or a bit less than one, so that the final merges are balanced. It's made of the TIMSORT_MIN_MERGE-sized prefix of the bits of the size, plus 1 if any of the remaining bits is set.
+ */
+static size_t timsort_minrun(size_t size)
+{
+    size_t r = 0;
+    while(size >= TIMSORT_MIN_MERGE) {
+        r |= size & 1;
+        size >>= 1;
     }
+    return size + r;
+}
 
-    free(left_array);
-    free(right_array);
+/*
+ * Maps an int to an unsigned key with the same order, by flipping the sign bit. This way, negative numbers come before the positive ones when the keys are sorted digit by digit.
+ */
+static inline unsigned int radix_key(int x) {
+    return ((unsigned int) x) ^ 0x80000000u;
 }
 
+#define PARTITION_BLOCK_SIZE 128 //elements scanned at a time by the block partitioning (at most 256, so that the offsets fit in a byte)
+#define INTROSORT_CUTOFF 24 //sub-arrays with up to this many elements are sorted by insertion sort in introsort
+#define INTROSORT_NINTHER_THRESHOLD 128 //sub-arrays bigger than this get the median of 3 medians of 3 (ninther) as pivot in introsort
+#define SWAP(a, b) do { ELEM swap_temp = (a);  (a) = (b);  (b) = swap_temp; } while(0) //swaps two elements of the type being instantiated
+
+//kernels of each element type (see kernel_instances.inc)
+#define INT_KERNELS
+#define ELEM int
+#define LESS LESS_VALUE
+#define TYPE_SUFFIX
+#include "kernel_instances.inc"
+#undef INT_KERNELS
+
+#define ELEM int64_t
+#define LESS LESS_VALUE
+#define TYPE_SUFFIX _int64
+#include "kernel_instances.inc"
+
+#define ELEM float
+#define LESS LESS_VALUE
+#define TYPE_SUFFIX _float
+#include "kernel_instances.inc"
+
+#define ELEM double
+#define LESS LESS_VALUE
+#define TYPE_SUFFIX _double
+#include "kernel_instances.inc"
+
+#define ELEM KeyValue
+#define LESS LESS_KEY
+#define TYPE_SUFFIX _kv
+#include "kernel_instances.inc"
+
+#define ELEM int64_t
+#define LESS LESS_CALLBACK
+#define TYPE_SUFFIX _int64_callback
+#include "kernel_instances.inc"
+
 /*
- * Merge sort algorithm used internally.
+ * Creates the SortingInfo of a single run of a kernel.
  */
-static void merge_sort_aux(int *array, int start_index, int end_index, long long int *comparisons_counter, long long int *swaps_counter)
+static SortingInfo* kernel_info(double time, SortCounters *counters)
 {
-    if(start_index < end_index) {
-        int m = (end_index + start_index)/2;
+    SortingInfo *info = malloc(sizeof(SortingInfo));  assert(info != NULL);
+    info->time = info->instrumented_time = time;
+    info->comparisons_count = counters->comparisons;
+    info->swaps_count = counters->swaps;
+    info->hw = counters->hw;
+    samples_init(&info->samples);
+    samples_add(&info->samples, time);
+    return info;
+}
 
-        merge_sort_aux(array, start_index, m, comparisons_counter, swaps_counter);
-        merge_sort_aux(array, m + 1, end_index, comparisons_counter, swaps_counter);
+/*
+ * Defines the public functions of an algorithm for an element type: "name<suffix>" runs the instrumented kernel and "name<suffix>_clean" runs the zero-overhead kernel (whose SortingInfo has no comparisons nor swaps).
+ * The kernels of both versions are also wrapped by functions that take a void pointer ("_generic"), which are the ones stored in the element types table.
+ */
+#define DEFINE_TYPED_SORT(name, suffix, type) \
+    SortingInfo* name##suffix(type *array, size_t size) { \
+        SortCounters counters = {0}; \
+        double time = name##suffix##_counted_kernel(array, size, &counters); \
+        return kernel_info(time, &counters); \
+    } \
+    SortingInfo* name##suffix##_clean(type *array, size_t size) { \
+        SortCounters counters = {0}; \
+        double time = name##suffix##_clean_kernel(array, size, &counters); \
+        return kernel_info(time, &counters); \
+    } \
+    static double name##suffix##_generic(void *array, size_t size, SortCounters *counters) {return name##suffix##_counted_kernel(array, size, counters);} \
+    static double name##suffix##_clean_generic(void *array, size_t size, SortCounters *counters) {return name##suffix##_clean_kernel(array, size, counters);}
+
+#define DEFINE_SORT(name) DEFINE_TYPED_SORT(name, , int)
+
+//the algorithms built for all the element types
+#define DEFINE_TYPED_SORTS(suffix, type) \
+    DEFINE_TYPED_SORT(bubble_sort, suffix, type) \
+    DEFINE_TYPED_SORT(flagged_bubble_sort, suffix, type) \
+    DEFINE_TYPED_SORT(selection_sort, suffix, type) \
+    DEFINE_TYPED_SORT(insertion_sort, suffix, type) \
+    DEFINE_TYPED_SORT(heapsort, suffix, type) \
+    DEFINE_TYPED_SORT(shellsort, suffix, type) \
+    DEFINE_TYPED_SORT(quicksort, suffix, type) \
+    DEFINE_TYPED_SORT(merge_sort, suffix, type) \
+    DEFINE_TYPED_SORT(introsort, suffix, type) \
+    DEFINE_TYPED_SORT(timsort, suffix, type)
+
+DEFINE_TYPED_SORTS(, int)
+DEFINE_SORT(parallel_quicksort)
+DEFINE_SORT(merge_sort_top_down)
+DEFINE_SORT(merge_sort_bottom_up)
+DEFINE_SORT(lsd_radix_sort)
+DEFINE_SORT(lsd_radix_sort_11bit)
+DEFINE_SORT(msd_radix_sort)
+DEFINE_SORT(quicksort_network)
+DEFINE_SORT(merge_sort_network)
+
+DEFINE_TYPED_SORTS(_int64, int64_t)
+DEFINE_TYPED_SORTS(_float, float)
+DEFINE_TYPED_SORTS(_double, double)
+DEFINE_TYPED_SORTS(_kv, KeyValue)
+DEFINE_TYPED_SORTS(_int64_callback, int64_t)
 
-        merge(array, start_index, m, end_index, comparisons_counter, swaps_counter);
-    }
+/*
+ * Instrumented merge sort that doesn't allocate memory while sorting (see merge_sort_buffered_counted_kernel). "buffer" may be NULL.
+ */
+SortingInfo* merge_sort_buffered(int *array, size_t size, int *buffer, bool top_down)
+{
+    SortCounters counters = {0};
+    double time = merge_sort_buffered_counted_kernel(array, size, buffer, top_down, &counters);
+    return kernel_info(time, &counters);
 }
 
 /*
- * Wrapper for the merge_sort_aux function.
+ * Instrumented LSD radix sort with digits of "digit_bits" bits (see lsd_radix_sort_digits_counted_kernel).
  */
-SortingInfo* merge_sort(int *array, int size)
+SortingInfo* lsd_radix_sort_digits(int *array, size_t size, int digit_bits)
 {
-    SortingInfo *info = malloc(sizeof(SortingInfo));
-    clock_t starting_clock = clock();
+    SortCounters counters = {0};
+    double time = lsd_radix_sort_digits_counted_kernel(array, size, digit_bits, &counters);
+    return kernel_info(time, &counters);
+}
 
-    long long int comparisons_counter, swaps_counter;
-    comparisons_counter = swaps_counter = 0;
-    
-    merge_sort_aux(array, 0, size-1, &comparisons_counter, &swaps_counter);
+/*
+ * Wraps the is_sorted function of an element type so that it takes a void pointer (its generate_into function already does, so it goes straight into the element types table).
+ */
+#define DEFINE_GENERIC_IS_SORTED(suffix, type) \
+    static bool is_sorted##suffix##_generic(const void *array, size_t size) {return is_sorted##suffix((type*) array, size);}
 
-    info->comparisons_count = comparisons_counter;
-    info->swaps_count = swaps_counter;
+DEFINE_GENERIC_IS_SORTED(, int)
+DEFINE_GENERIC_IS_SORTED(_int64, int64_t)
+DEFINE_GENERIC_IS_SORTED(_float, float)
+DEFINE_GENERIC_IS_SORTED(_double, double)
+DEFINE_GENERIC_IS_SORTED(_kv, KeyValue)
 
-    info->time = ( (double) (clock() - starting_clock) ) / CLOCKS_PER_SEC;
-    return info;
+/*
+ * Returns true if the key/value records are sorted by their keys and the records with equal keys are still in their original order (their values are their original positions, see MAKE_KV).
+ */
+static bool is_stably_sorted_kv_generic(const void *array, size_t size) {
+    const KeyValue *a = array;
+    for(size_t i = 0; i + 1 < size; i++) {
+        if(a[i+1].key < a[i].key || (a[i+1].key == a[i].key && a[i+1].value < a[i].value))
+            return false;
+    }
+    return true;
 }
+
+//initializers of the kernels of an element type, in the order of the ALGORITHMS table
+#define TYPED_SORTS(suffix, version) \
+    &bubble_sort##suffix##version##_generic, &flagged_bubble_sort##suffix##version##_generic, &selection_sort##suffix##version##_generic, &insertion_sort##suffix##version##_generic, \
+    &heapsort##suffix##version##_generic, &shellsort##suffix##version##_generic, &quicksort##suffix##version##_generic, &merge_sort##suffix##version##_generic, \
+    &introsort##suffix##version##_generic, &timsort##suffix##version##_generic
+#define INT_ONLY_SORTS(version) \
+    &merge_sort_top_down##version##_generic, &merge_sort_bottom_up##version##_generic, &parallel_quicksort##version##_generic, \
+    &lsd_radix_sort##version##_generic, &lsd_radix_sort_11bit##version##_generic, &msd_radix_sort##version##_generic, \
+    &quicksort_network##version##_generic, &merge_sort_network##version##_generic
+
+static const ElementType ELEMENT_TYPES[NUM_ELEMENT_TYPES] = {
+    {"int", "int (32 bits)", sizeof(int), {TYPED_SORTS(, ), INT_ONLY_SORTS()}, {TYPED_SORTS(, _clean), INT_ONLY_SORTS(_clean)}, &generate_into, &is_sorted_generic},
+    {"int64", "int64_t", sizeof(int64_t), {TYPED_SORTS(_int64, )}, {TYPED_SORTS(_int64, _clean)}, &generate_into_int64, &is_sorted_int64_generic},
+    {"float", "float", sizeof(float), {TYPED_SORTS(_float, )}, {TYPED_SORTS(_float, _clean)}, &generate_into_float, &is_sorted_float_generic},
+    {"double", "double", sizeof(double), {TYPED_SORTS(_double, )}, {TYPED_SORTS(_double, _clean)}, &generate_into_double, &is_sorted_double_generic},
+    {"kv", "key/value record (16 bytes)", sizeof(KeyValue), {TYPED_SORTS(_kv, )}, {TYPED_SORTS(_kv, _clean)}, &generate_into_kv, &is_sorted_kv_generic, &is_stably_sorted_kv_generic},
+    {"int64_callback", "int64_t (comparator callback)", sizeof(int64_t), {TYPED_SORTS(_int64_callback, )}, {TYPED_SORTS(_int64_callback, _clean)}, &generate_into_int64, &is_sorted_int64_generic}
+};
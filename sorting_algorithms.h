@@ -6,32 +6,234 @@
 #ifndef SORTING_ALGORITHMS_H
     #define SORTING_ALGORITHMS_H
     #include <stdbool.h>
+    #include <stddef.h>
     #include <stdio.h>
+    #include <stdint.h>
+    #include "statistics.h"
+    #include "generators.h"
+    #include "sort_plugin.h"
+
+    /*
+     * Registry of the algorithms run by analyze_case: the built-in ones, followed by the ones registered by the sort plugins (see plugins.h).
+     */
+    #define NUM_BUILTIN_ALGORITHMS 18
+    #define NUM_TYPED_ALGORITHMS 10 //the first algorithms of the table, which are also built for the element types other than int
+    #define MAX_ALGORITHMS 64 //size of the registry, including the plugins
+
+    int get_num_algorithms(void);
+    const char* get_algorithm_id(int index);
+    const char* get_algorithm_name(int index);
+    unsigned int get_algorithm_properties(int index); //SORT_STABLE | SORT_IN_PLACE | SORT_PARALLEL (see sort_plugin.h)
+    bool is_plugin_algorithm(int index);
+    struct SortingInfo* (*get_algorithm_sort(int index, bool instrumented))(int *array, size_t size); //NULL for the plugins
+    int find_algorithm(const char *id);
+    void fprint_algorithm_properties(FILE *file, int index);
 
     typedef struct SortingInfo SortingInfo;
     double get_execution_time(SortingInfo *info);
+    double get_instrumented_time(SortingInfo *info);
     long long int get_comparisons_count(SortingInfo *info); 
     long long int get_swaps_count(SortingInfo *info);
+    long long int get_cycles(SortingInfo *info);
+    long long int get_instructions(SortingInfo *info);
+    long long int get_l1_misses(SortingInfo *info);
+    long long int get_llc_misses(SortingInfo *info);
+    long long int get_branch_misses(SortingInfo *info);
+    const Samples* get_time_samples(SortingInfo *info);
+    TimeStatistics get_time_statistics(SortingInfo *info);
+    void free_sorting_info(SortingInfo *info);
+
+    #define EXIT_OUT_OF_MEMORY 4 //exit code used when a buffer needed by a sort can't be allocated
+    void* checked_malloc(size_t count, size_t elem_size);
 
     void swap(int *a, int *b);
-    bool is_sorted(int *array, int size);
+    bool is_sorted(int *array, size_t size);
+    int scaled_value(size_t i, size_t max);
+
+    int* generate_array(int array_case, size_t size, int sample); //any of the cases of generators.h
+    int* random_array(size_t size);
+    int* sorted_array(size_t size);
+    int* almost_sorted_array(size_t size);
+    int* inversely_sorted_array(size_t size);
+    int* few_unique_array(size_t size);
 
-    int* random_array(int size);
-    int* sorted_array(int size);
-    int* almost_sorted_array(int size, int k);
-    int* inversely_sorted_array(int size);
+    /*
+     * Element types of the arrays. Besides int, the first NUM_TYPED_ALGORITHMS algorithms (the eight classic ones, introsort and timsort) are also generated (from the same source, with the comparisons inlined) for:
+     * int64_t ("_int64" suffix), float ("_float"), double ("_double"), 16-byte key/value records ordered by their keys ("_kv") and int64_t compared through a qsort-style comparator callback ("_int64_callback"), which measures the cost of the indirection.
+     */
+    #define NUM_ELEMENT_TYPES 6
+    #define INT_ELEMENTS 0 //index of int in the element types table
+    typedef struct {
+        int64_t key, value;
+    } KeyValue;
+
+    const char* get_element_type_id(int type);
+    const char* get_element_type_name(int type);
+    int find_element_type(const char *id);
+    bool is_algorithm_available(int type, int algorithm);
+    int register_algorithm(const char *id, const char *name, unsigned int properties, const SortPluginFunction sorts[NUM_ELEMENT_TYPES]);
+    int compare_int64(const void *a, const void *b);
+    void set_int64_comparator(int (*compare)(const void *a, const void *b));
     
-    SortingInfo* analyze_sorting_algorithm(SortingInfo* (*sort)(int *array, int size), int* (*generate_array)(int size), int size, int num_executions);
-    SortingInfo*** analyze_case_on_all(int* (*generate_array)(int size), int min_size_exp, int max_size_exp, int num_executions);
-    void save_sorting_info(SortingInfo *rand_info, SortingInfo* semi_info, SortingInfo* inv_info, SortingInfo* sorted_info, int arrays_size, int num_executions, FILE *file);
-
-    SortingInfo* bubble_sort(int *array, int size);
-    SortingInfo* flagged_bubble_sort(int *array, int size);
-    SortingInfo* selection_sort(int *array, int size);
-    SortingInfo* insertion_sort(int *array, int size);
-
-    SortingInfo* shellsort(int *array, int size);
-    SortingInfo* heapsort(int *array, int size);
-    SortingInfo* quicksort(int *array, int size);
-    SortingInfo* merge_sort(int *array, int size);
+    SortingInfo* analyze_sorting_algorithm(int type, int algorithm, int array_case, size_t size, int num_executions, const StatisticsConfig *config);
+    SortingInfo* measure_sorting_algorithm(int type, int algorithm, const void *array, void *temp_array, size_t size, const StatisticsConfig *config, bool *sorted);
+    bool verify_sorting_algorithm(int type, int algorithm, int array_case, size_t size);
+    int get_num_cores(void);
+
+    /*
+     * Time budget of the benchmarks (see set_time_budget). Each limit is disabled when it's 0.
+     */
+    typedef struct {
+        double cell_seconds; //time of all the sorts of an algorithm on a size (all the executions)
+        double total_seconds; //time of all the benchmarks run after set_time_budget is called
+        double timeout_seconds; //hard limit of a single sort (the sorts are run in a child process, which is killed when it's reached)
+    } TimeBudget;
+
+    void set_time_budget(TimeBudget budget);
+    TimeBudget get_time_budget(void);
+
+    /*
+     * Results of analyze_case: a matrix with the performance of each algorithm on each size. A cell may have been skipped, because it was predicted to exceed the time budget, have timed out or have been dropped because the arrays of its size didn't fit into memory.
+     */
+    #define CELL_MEASURED 0
+    #define CELL_SKIPPED 1
+    #define CELL_TIMED_OUT 2
+    #define CELL_NO_MEMORY 3
+
+    typedef struct CaseResults CaseResults;
+    SortingInfo* get_case_result(CaseResults *results, int algorithm, int size_index);
+    int get_case_result_state(CaseResults *results, int algorithm, int size_index, double *predicted_time);
+    void free_case_results(CaseResults *results);
+
+    struct ResultsWriter; //see results_writer.h
+    CaseResults* analyze_case(int type, int array_case, const size_t *sizes, int num_sizes, const bool *selected, int num_executions, int num_workers, bool pin_workers, const StatisticsConfig *config,
+                              struct ResultsWriter *writer);
+    CaseResults* analyze_case_on_all(int array_case, int min_size_exp, int max_size_exp, int num_executions, int num_workers, bool pin_workers, const StatisticsConfig *config);
+    void time_now_to_file(FILE *file);
+    void fprint_case(FILE *file, CaseResults *results, int algorithm, const size_t *sizes);
+    void fprint_hw_counters(FILE *file, SortingInfo *info);
+    void fprint_time_statistics(FILE *file, SortingInfo *info);
+    void save_sorting_info(SortingInfo *infos[NUM_CASES], size_t arrays_size, int num_executions, FILE *file);
+
+    //instrumented (counting) versions of the algorithms
+    SortingInfo* bubble_sort(int *array, size_t size);
+    SortingInfo* flagged_bubble_sort(int *array, size_t size);
+    SortingInfo* selection_sort(int *array, size_t size);
+    SortingInfo* insertion_sort(int *array, size_t size);
+
+    SortingInfo* shellsort(int *array, size_t size);
+    SortingInfo* heapsort(int *array, size_t size);
+    SortingInfo* quicksort(int *array, size_t size);
+    SortingInfo* merge_sort(int *array, size_t size);
+    SortingInfo* introsort(int *array, size_t size);
+    SortingInfo* timsort(int *array, size_t size);
+
+    /*
+     * Gap sequences of shellsort, generated for the size of each array (see set_shellsort_gaps). The default is Ciura's sequence, extended by a factor of 2.25.
+     */
+    #define CIURA_GAPS 0
+    #define TOKUDA_GAPS 1
+    #define SEDGEWICK_GAPS 2
+    #define PRATT_GAPS 3
+    #define NUM_GAP_SEQUENCES 4
+
+    void set_shellsort_gaps(int sequence);
+    int get_shellsort_gaps(void);
+    const char* get_gap_sequence_id(int sequence);
+    int find_gap_sequence(const char *id);
+    void set_shellsort_threads(int num_threads);
+    int get_shellsort_threads(void);
+
+    /*
+     * Heap used by heapsort: the classic binary heap ({2, false, false}, the default) or a d-ary heap, with an optional bottom-up sift and prefetching of the grandchildren (see set_heap_variant).
+     */
+    typedef struct {
+        int arity; //2, 4 or 8
+        bool bottom_up, prefetch;
+    } HeapVariant;
+
+    bool set_heap_variant(HeapVariant variant);
+    HeapVariant get_heap_variant(void);
+
+    /*
+     * Partitioning methods of the quicksorts: Hoare's (the default), block partitioning (BlockQuicksort: branch-free scans that buffer the offsets of the misplaced elements and swap them in batches) and branchless Lomuto.
+     */
+    #define HOARE_PARTITION 0
+    #define BLOCK_PARTITION 1
+    #define LOMUTO_PARTITION 2
+    #define NUM_PARTITIONS 3
+
+    void set_quicksort_partition(int partition);
+    int get_quicksort_partition(void);
+    const char* get_partition_id(int partition);
+    int find_partition(const char *id);
+
+    void set_parallel_quicksort_threads(int num_threads);
+    SortingInfo* parallel_quicksort(int *array, size_t size);
+    SortingInfo* merge_sort_buffered(int *array, size_t size, int *buffer, bool top_down);
+    SortingInfo* merge_sort_top_down(int *array, size_t size);
+    SortingInfo* merge_sort_bottom_up(int *array, size_t size);
+
+    SortingInfo* lsd_radix_sort_digits(int *array, size_t size, int digit_bits);
+    SortingInfo* lsd_radix_sort(int *array, size_t size);
+    SortingInfo* lsd_radix_sort_11bit(int *array, size_t size);
+    SortingInfo* msd_radix_sort(int *array, size_t size);
+
+    void set_network_leaf_size(int size);
+    int get_network_leaf_size(void);
+    SortingInfo* quicksort_network(int *array, size_t size);
+    SortingInfo* merge_sort_network(int *array, size_t size);
+
+    //zero-overhead versions of the algorithms (built from the same source, with the counting compiled away): no comparisons nor swaps are reported
+    SortingInfo* bubble_sort_clean(int *array, size_t size);
+    SortingInfo* flagged_bubble_sort_clean(int *array, size_t size);
+    SortingInfo* selection_sort_clean(int *array, size_t size);
+    SortingInfo* insertion_sort_clean(int *array, size_t size);
+
+    SortingInfo* shellsort_clean(int *array, size_t size);
+    SortingInfo* heapsort_clean(int *array, size_t size);
+    SortingInfo* quicksort_clean(int *array, size_t size);
+    SortingInfo* merge_sort_clean(int *array, size_t size);
+    SortingInfo* introsort_clean(int *array, size_t size);
+    SortingInfo* timsort_clean(int *array, size_t size);
+
+    SortingInfo* parallel_quicksort_clean(int *array, size_t size);
+    SortingInfo* merge_sort_top_down_clean(int *array, size_t size);
+    SortingInfo* merge_sort_bottom_up_clean(int *array, size_t size);
+
+    SortingInfo* lsd_radix_sort_clean(int *array, size_t size);
+    SortingInfo* lsd_radix_sort_11bit_clean(int *array, size_t size);
+    SortingInfo* msd_radix_sort_clean(int *array, size_t size);
+
+    SortingInfo* quicksort_network_clean(int *array, size_t size);
+    SortingInfo* merge_sort_network_clean(int *array, size_t size);
+
+    //instrumented and zero-overhead versions of the algorithms built for each of the other element types (e.g. quicksort_int64 and quicksort_int64_clean)
+    #define DECLARE_TYPED_SORTS(suffix, type) \
+        SortingInfo* bubble_sort##suffix(type *array, size_t size);  SortingInfo* bubble_sort##suffix##_clean(type *array, size_t size); \
+        SortingInfo* flagged_bubble_sort##suffix(type *array, size_t size);  SortingInfo* flagged_bubble_sort##suffix##_clean(type *array, size_t size); \
+        SortingInfo* selection_sort##suffix(type *array, size_t size);  SortingInfo* selection_sort##suffix##_clean(type *array, size_t size); \
+        SortingInfo* insertion_sort##suffix(type *array, size_t size);  SortingInfo* insertion_sort##suffix##_clean(type *array, size_t size); \
+        SortingInfo* shellsort##suffix(type *array, size_t size);  SortingInfo* shellsort##suffix##_clean(type *array, size_t size); \
+        SortingInfo* heapsort##suffix(type *array, size_t size);  SortingInfo* heapsort##suffix##_clean(type *array, size_t size); \
+        SortingInfo* quicksort##suffix(type *array, size_t size);  SortingInfo* quicksort##suffix##_clean(type *array, size_t size); \
+        SortingInfo* merge_sort##suffix(type *array, size_t size);  SortingInfo* merge_sort##suffix##_clean(type *array, size_t size); \
+        SortingInfo* introsort##suffix(type *array, size_t size);  SortingInfo* introsort##suffix##_clean(type *array, size_t size); \
+        SortingInfo* timsort##suffix(type *array, size_t size);  SortingInfo* timsort##suffix##_clean(type *array, size_t size);
+
+    DECLARE_TYPED_SORTS(_int64, int64_t)
+    DECLARE_TYPED_SORTS(_float, float)
+    DECLARE_TYPED_SORTS(_double, double)
+    DECLARE_TYPED_SORTS(_kv, KeyValue)
+    DECLARE_TYPED_SORTS(_int64_callback, int64_t)
+
+    //generators of the other element types, with the same values as the int ones (the values of the key/value records are the original positions of their keys); the int64_callback sorts use the int64 ones
+    #define DECLARE_TYPED_GENERATORS(suffix, type) \
+        type* generate_array##suffix(int array_case, size_t size, int sample); \
+        bool is_sorted##suffix(const type *array, size_t size);
+
+    DECLARE_TYPED_GENERATORS(_int64, int64_t)
+    DECLARE_TYPED_GENERATORS(_float, float)
+    DECLARE_TYPED_GENERATORS(_double, double)
+    DECLARE_TYPED_GENERATORS(_kv, KeyValue)
 #endif
@@ -0,0 +1,251 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include "sorting_networks.h"
+#include <limits.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define X86_NETWORKS //the SIMD networks are compiled with target attributes, so the rest of the program doesn't need -mavx2
+#endif
+
+static const char *ISA_IDS[NUM_NETWORK_ISAS] = {"auto", "scalar", "sse4", "avx2"};
+
+static void (*network_sort)(int *block, int width); //implementation of the selected instruction set
+static int network_isa;
+static pthread_once_t network_once = PTHREAD_ONCE_INIT;
+
+/*
+ * Bitonic sorting network of "width" (a power of 2) elements, one compare-exchange at a time. For each stage k (size of the sorted sequences being built) and step j (distance between the compared elements), element i is compared with element i^j and the pair is sorted in ascending order if (i & k) == 0 and in descending order otherwise.
+ * The min/max are written with conditional expressions, which the compiler turns into conditional moves, so the network has no data-dependent branches.
+ */
+static void bitonic_sort_scalar(int *a, int width)
+{
+    for(int k = 2; k <= width; k *= 2) {
+        for(int j = k/2; j > 0; j /= 2) {
+            for(int i = 0; i < width; i++) {
+                int l = i ^ j;
+                if(l < i)
+                    continue;
+
+                int lo = (a[i] < a[l]) ? a[i] : a[l],
+                    hi = (a[i] < a[l]) ? a[l] : a[i];
+                bool ascending = (i & k) == 0;
+                a[i] = ascending ? lo : hi;
+                a[l] = ascending ? hi : lo;
+            }
+        }
+    }
+}
+
+#ifdef X86_NETWORKS
+/*
+ * Same network as bitonic_sort_scalar, with the elements kept in 8-lane AVX2 registers. Steps with j >= 8 compare whole registers (all of their lanes go in the same direction); steps with j < 8 compare each register with a permuted copy of itself, and each lane takes the min or the max depending on whether it's the lower index of its pair and on the direction of its sequence.
+ */
+__attribute__((target("avx2")))
+static void bitonic_sort_avx2(int *a, int width)
+{
+    __m256i v[SORTING_NETWORK_MAX / 8];
+    const int num_vectors = width / 8;
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), zero = _mm256_setzero_si256();
+    for(int r = 0; r < num_vectors; r++)
+        v[r] = _mm256_loadu_si256((const __m256i*) &a[8*r]);
+
+    for(int k = 2; k <= width; k *= 2) {
+        for(int j = k/2; j > 0; j /= 2) {
+            if(j >= 8) {
+                for(int r = 0; r < num_vectors; r++) {
+                    int s = r + j/8;
+                    if(r & (j/8))
+                        continue;
+
+                    __m256i lo = _mm256_min_epi32(v[r], v[s]), hi = _mm256_max_epi32(v[r], v[s]);
+                    bool ascending = ((8*r) & k) == 0;
+                    v[r] = ascending ? lo : hi;
+                    v[s] = ascending ? hi : lo;
+                }
+                continue;
+            }
+
+            const __m256i partner = _mm256_xor_si256(lanes, _mm256_set1_epi32(j));
+            for(int r = 0; r < num_vectors; r++) {
+                __m256i index = _mm256_add_epi32(lanes, _mm256_set1_epi32(8*r)),
+                        lower = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(j)), zero),
+                        ascending = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(k)), zero),
+                        take_min = _mm256_cmpeq_epi32(lower, ascending);
+
+                __m256i p = _mm256_permutevar8x32_epi32(v[r], partner);
+                v[r] = _mm256_blendv_epi8(_mm256_max_epi32(v[r], p), _mm256_min_epi32(v[r], p), take_min);
+            }
+        }
+    }
+
+    for(int r = 0; r < num_vectors; r++)
+        _mm256_storeu_si256((__m256i*) &a[8*r], v[r]);
+}
+
+/*
+ * Same network as bitonic_sort_avx2, with 4-lane SSE4.1 registers (the in-register permutations are fixed shuffles).
+ */
+__attribute__((target("sse4.1")))
+static void bitonic_sort_sse4(int *a, int width)
+{
+    __m128i v[SORTING_NETWORK_MAX / 4];
+    const int num_vectors = width / 4;
+    const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3), zero = _mm_setzero_si128();
+    for(int r = 0; r < num_vectors; r++)
+        v[r] = _mm_loadu_si128((const __m128i*) &a[4*r]);
+
+    for(int k = 2; k <= width; k *= 2) {
+        for(int j = k/2; j > 0; j /= 2) {
+            if(j >= 4) {
+                for(int r = 0; r < num_vectors; r++) {
+                    int s = r + j/4;
+                    if(r & (j/4))
+                        continue;
+
+                    __m128i lo = _mm_min_epi32(v[r], v[s]), hi = _mm_max_epi32(v[r], v[s]);
+                    bool ascending = ((4*r) & k) == 0;
+                    v[r] = ascending ? lo : hi;
+                    v[s] = ascending ? hi : lo;
+                }
+                continue;
+            }
+
+            for(int r = 0; r < num_vectors; r++) {
+                __m128i index = _mm_add_epi32(lanes, _mm_set1_epi32(4*r)),
+                        lower = _mm_cmpeq_epi32(_mm_and_si128(index, _mm_set1_epi32(j)), zero),
+                        ascending = _mm_cmpeq_epi32(_mm_and_si128(index, _mm_set1_epi32(k)), zero),
+                        take_min = _mm_cmpeq_epi32(lower, ascending);
+
+                __m128i p = (j == 1) ? _mm_shuffle_epi32(v[r], _MM_SHUFFLE(2, 3, 0, 1)) : _mm_shuffle_epi32(v[r], _MM_SHUFFLE(1, 0, 3, 2));
+                v[r] = _mm_blendv_epi8(_mm_max_epi32(v[r], p), _mm_min_epi32(v[r], p), take_min);
+            }
+        }
+    }
+
+    for(int r = 0; r < num_vectors; r++)
+        _mm_storeu_si128((__m128i*) &a[4*r], v[r]);
+}
+#endif
+
+/*
+ * Returns true if the CPU supports the given instruction set.
+ */
+static bool isa_supported(int isa)
+{
+#ifdef X86_NETWORKS
+    __builtin_cpu_init();
+    if(isa == NETWORK_ISA_AVX2)
+        return __builtin_cpu_supports("avx2");
+    if(isa == NETWORK_ISA_SSE4)
+        return __builtin_cpu_supports("sse4.1");
+#endif
+    return isa == NETWORK_ISA_SCALAR;
+}
+
+/*
+ * Selects the best instruction set supported by the CPU, unless one was already chosen.
+ */
+static void select_best_isa(void)
+{
+    if(network_sort == NULL)
+        set_sorting_network_isa(NETWORK_ISA_AUTO);
+}
+
+/*
+ * Selects the instruction set of the sorting networks. Returns false (and keeps the current one) if the CPU doesn't support it.
+ * Not thread-safe: must be called before any sort starts.
+ */
+bool set_sorting_network_isa(int isa)
+{
+    if(isa == NETWORK_ISA_AUTO)
+        isa = isa_supported(NETWORK_ISA_AVX2) ? NETWORK_ISA_AVX2 : (isa_supported(NETWORK_ISA_SSE4) ? NETWORK_ISA_SSE4 : NETWORK_ISA_SCALAR);
+    if(!isa_supported(isa))
+        return false;
+
+    network_isa = isa;
+    network_sort = &bitonic_sort_scalar;
+#ifdef X86_NETWORKS
+    if(isa == NETWORK_ISA_AVX2)
+        network_sort = &bitonic_sort_avx2;
+    else if(isa == NETWORK_ISA_SSE4)
+        network_sort = &bitonic_sort_sse4;
+#endif
+    return true;
+}
+
+/*
+ * Returns the instruction set used by the sorting networks.
+ */
+int get_sorting_network_isa(void) {
+    pthread_once(&network_once, &select_best_isa);
+    return network_isa;
+}
+
+const char* get_network_isa_id(int isa) {return ISA_IDS[isa];}
+
+/*
+ * Returns the instruction set with the given id or -1 if there's no such instruction set.
+ */
+int find_network_isa(const char *id)
+{
+    for(int i = 0; i < NUM_NETWORK_ISAS; i++) {
+        if(strcmp(ISA_IDS[i], id) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/*
+ * Width of the network that sorts "size" elements: the smallest power of 2 that isn't lower than the size nor than 8 (the width of an AVX2 register).
+ */
+static int network_width(size_t size)
+{
+    int width = 8;
+    while((size_t) width < size)
+        width *= 2;
+    return width;
+}
+
+/*
+ * Sorts an array of up to SORTING_NETWORK_MAX elements with a bitonic sorting network. If the size isn't a power of 2 (of at least 8), the elements are copied to a block padded with INT_MAX, which ends up after them.
+ */
+void sorting_network(int *array, size_t size)
+{
+    assert(size <= SORTING_NETWORK_MAX);
+    if(size < 2)
+        return;
+
+    pthread_once(&network_once, &select_best_isa);
+    int width = network_width(size);
+    if((size_t) width == size) {
+        network_sort(array, width);
+        return;
+    }
+
+    int block[SORTING_NETWORK_MAX];
+    memcpy(block, array, size * sizeof(int));
+    for(int i = size; i < width; i++)
+        block[i] = INT_MAX;
+    network_sort(block, width);
+    memcpy(array, block, size * sizeof(int));
+}
+
+/*
+ * Returns the number of compare-exchanges made by the network that sorts "size" elements (width/4 * log2(width) * (log2(width) + 1)).
+ */
+long long int sorting_network_comparators(size_t size)
+{
+    if(size < 2)
+        return 0;
+
+    int width = network_width(size), log_width = 0;
+    while((1 << log_width) < width)
+        log_width++;
+    return (long long int) width / 4 * log_width * (log_width + 1);
+}
@@ -0,0 +1,29 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef SORTING_NETWORKS_H
+    #define SORTING_NETWORKS_H
+    #include <stdbool.h>
+    #include <stddef.h>
+
+    #define SORTING_NETWORK_MAX 64 //maximum number of elements sorted by a network
+
+    /*
+     * Instruction sets of the bitonic sorting networks. NETWORK_ISA_AUTO picks the best one supported by the CPU (checked at runtime).
+     */
+    #define NETWORK_ISA_AUTO 0
+    #define NETWORK_ISA_SCALAR 1
+    #define NETWORK_ISA_SSE4 2
+    #define NETWORK_ISA_AVX2 3
+    #define NUM_NETWORK_ISAS 4
+
+    bool set_sorting_network_isa(int isa);
+    int get_sorting_network_isa(void);
+    const char* get_network_isa_id(int isa);
+    int find_network_isa(const char *id);
+
+    void sorting_network(int *array, size_t size);
+    long long int sorting_network_comparators(size_t size);
+#endif
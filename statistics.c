@@ -0,0 +1,199 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#include "statistics.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+void samples_init(Samples *samples) {
+    samples->values = NULL;
+    samples->count = samples->capacity = 0;
+}
+
+/*
+ * Makes room for at least "capacity" samples, so that they can be added without reallocating the list.
+ */
+void samples_reserve(Samples *samples, int capacity)
+{
+    if(capacity > samples->capacity) {
+        samples->capacity = capacity;
+        samples->values = realloc(samples->values, samples->capacity * sizeof(double));  assert(samples->values != NULL);
+    }
+}
+
+void samples_add(Samples *samples, double value)
+{
+    if(samples->count == samples->capacity) {
+        samples->capacity = (samples->capacity == 0) ? 8 : 2*samples->capacity;
+        samples->values = realloc(samples->values, samples->capacity * sizeof(double));  assert(samples->values != NULL);
+    }
+    samples->values[samples->count++] = value;
+}
+
+/*
+ * Adds all the samples in src to dst.
+ */
+void samples_append(Samples *dst, const Samples *src)
+{
+    for(int i = 0; i < src->count; i++)
+        samples_add(dst, src->values[i]);
+}
+
+/*
+ * Removes all the samples, keeping the memory of the list.
+ */
+void samples_clear(Samples *samples) {
+    samples->count = 0;
+}
+
+void samples_free(Samples *samples) {
+    free(samples->values);
+    samples_init(samples);
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double*) a, y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Returns the p-th percentile (0 <= p <= 100) of the given sorted values, linearly interpolating between the closest ranks.
+ */
+double percentile(const double *sorted_values, int count, double p)
+{
+    if(count == 0)
+        return 0;
+
+    double rank = (p / 100.0) * (count - 1);
+    int lower = (int) rank;
+    if(lower >= count - 1)
+        return sorted_values[count - 1];
+
+    return sorted_values[lower] + (rank - lower) * (sorted_values[lower + 1] - sorted_values[lower]);
+}
+
+/*
+ * Two-sided 95% critical value of Student's t distribution with the given degrees of freedom.
+ */
+static double t_critical_95(int degrees_of_freedom)
+{
+    static const double T_TABLE[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if(degrees_of_freedom < 1)
+        return INFINITY;
+    if(degrees_of_freedom <= 30)
+        return T_TABLE[degrees_of_freedom - 1];
+    return 1.96 + 2.4 / degrees_of_freedom; //close to the t distribution for large samples and converges to the normal one
+}
+
+TimeStatistics compute_statistics(const Samples *samples)
+{
+    TimeStatistics stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.num_samples = samples->count;
+    if(samples->count == 0)
+        return stats;
+
+    double *sorted = malloc(samples->count * sizeof(double));  assert(sorted != NULL);
+    memcpy(sorted, samples->values, samples->count * sizeof(double));
+    qsort(sorted, samples->count, sizeof(double), &compare_doubles);
+
+    stats.min = sorted[0];
+    stats.median = percentile(sorted, samples->count, 50);
+    stats.p90 = percentile(sorted, samples->count, 90);
+    stats.p99 = percentile(sorted, samples->count, 99);
+
+    double sum = 0;
+    for(int i = 0; i < samples->count; i++)
+        sum += sorted[i];
+    stats.mean = sum / samples->count;
+
+    double squares = 0;
+    for(int i = 0; i < samples->count; i++)
+        squares += (sorted[i] - stats.mean) * (sorted[i] - stats.mean);
+    stats.stddev = (samples->count > 1) ? sqrt(squares / (samples->count - 1)) : 0;
+
+    double half_width = (samples->count > 1) ? t_critical_95(samples->count - 1) * stats.stddev / sqrt(samples->count) : INFINITY;
+    stats.ci_low = stats.mean - half_width;
+    stats.ci_high = stats.mean + half_width;
+
+    free(sorted);
+    return stats;
+}
+
+/*
+ * Returns the half-width of the 95% confidence interval of the mean divided by the mean.
+ */
+double relative_error(const TimeStatistics *stats)
+{
+    if(stats->num_samples < 2 || stats->mean <= 0)
+        return INFINITY;
+    return (stats->ci_high - stats->mean) / stats->mean;
+}
+
+/*
+ * Fits y = constant * x^exponent to the given points by least squares on a log-log scale. Points with non-positive coordinates are ignored. Both fields are NAN if fewer than 2 distinct x remain.
+ */
+PowerLaw fit_power_law(const double *x, const double *y, int count)
+{
+    double sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+    int n = 0;
+    for(int i = 0; i < count; i++) {
+        if(x[i] <= 0 || y[i] <= 0)
+            continue;
+        double lx = log(x[i]), ly = log(y[i]);
+        sum_x += lx;  sum_y += ly;  sum_xx += lx*lx;  sum_xy += lx*ly;
+        n++;
+    }
+
+    double denominator = n*sum_xx - sum_x*sum_x;
+    if(n < 2 || denominator <= 1e-12 * n*sum_xx)
+        return (PowerLaw) {NAN, NAN};
+    double exponent = (n*sum_xy - sum_x*sum_y) / denominator;
+    return (PowerLaw) {exponent, exp((sum_y - exponent*sum_x) / n)};
+}
+
+/*
+ * Two-sided p-value of the Mann-Whitney U test: the probability of samples at least this far apart if both lists came from the same distribution. It makes no assumption about the shape of the distributions, which is why it suits execution times (skewed by interruptions).
+ * Uses the normal approximation of U, with the correction for ties and the continuity correction, so it's rough below ~8 samples per list. Returns 1 if any of the lists is empty.
+ */
+double mann_whitney_p_value(const Samples *a, const Samples *b)
+{
+    int na = a->count, nb = b->count, n = na + nb;
+    if(na == 0 || nb == 0)
+        return 1;
+
+    //ranks of the pooled samples (ties get the mean of their ranks)
+    typedef struct {double value; int from_a;} Ranked;
+    Ranked *pooled = malloc(n * sizeof(Ranked));  assert(pooled != NULL);
+    for(int i = 0; i < na; i++)
+        pooled[i] = (Ranked) {a->values[i], 1};
+    for(int i = 0; i < nb; i++)
+        pooled[na + i] = (Ranked) {b->values[i], 0};
+    qsort(pooled, n, sizeof(Ranked), &compare_doubles); //"value" is the first member
+
+    double rank_sum_a = 0, ties = 0;
+    for(int i = 0; i < n; ) {
+        int j = i;
+        while(j < n && pooled[j].value == pooled[i].value)
+            j++;
+        double rank = (i + 1 + j) / 2.0, t = j - i;
+        for(int k = i; k < j; k++)
+            rank_sum_a += pooled[k].from_a ? rank : 0;
+        ties += t*t*t - t;
+        i = j;
+    }
+    free(pooled);
+
+    double u = rank_sum_a - na * (na + 1) / 2.0, mean = na * (double) nb / 2;
+    double variance = na * (double) nb / 12 * ((n + 1) - ties / ((double) n * (n - 1)));
+    if(variance <= 0)
+        return 1; //all the samples are equal
+    double z = fmax(fabs(u - mean) - 0.5, 0) / sqrt(variance);
+    return erfc(z / sqrt(2));
+}
@@ -0,0 +1,54 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+#ifndef STATISTICS_H
+    #define STATISTICS_H
+
+    /*
+     * Growable list of samples (execution times, in seconds).
+     */
+    typedef struct {
+        double *values;
+        int count, capacity;
+    } Samples;
+
+    /*
+     * Descriptive statistics of a list of samples. The confidence interval is the 95% CI of the mean.
+     */
+    typedef struct {
+        int num_samples;
+        double min, median, p90, p99, mean, stddev, ci_low, ci_high;
+    } TimeStatistics;
+
+    /*
+     * Settings of the statistics mode: each input is sorted "warmup_runs" times without being measured and then measured at least "min_runs" times, until the relative error of the mean (half-width of its 95% CI divided by the mean) gets below "target_relative_error" or "max_runs" is reached (0 = no limit).
+     */
+    typedef struct {
+        int warmup_runs, min_runs, max_runs;
+        double target_relative_error;
+    } StatisticsConfig;
+
+    void samples_init(Samples *samples);
+    void samples_reserve(Samples *samples, int capacity);
+    void samples_add(Samples *samples, double value);
+    void samples_append(Samples *dst, const Samples *src);
+    void samples_clear(Samples *samples);
+    void samples_free(Samples *samples);
+
+    TimeStatistics compute_statistics(const Samples *samples);
+    double relative_error(const TimeStatistics *stats);
+    double percentile(const double *sorted_values, int count, double p);
+
+    /*
+     * Power law y = constant * x^exponent, e.g. the time of a sort as a function of the size of the array.
+     */
+    typedef struct {
+        double exponent, constant;
+    } PowerLaw;
+
+    PowerLaw fit_power_law(const double *x, const double *y, int count);
+
+    double mann_whitney_p_value(const Samples *a, const Samples *b);
+#endif
@@ -0,0 +1,263 @@
+/*
+ *  Universidade de São Paulo - ICMC
+ *  Gabriel Nogueira (Talendar)
+ */
+
+/*
+ * Tests of the harness, run by "make check":
+ *  - every algorithm (both versions, on every element type, case and on small sizes, plus a size above the parallel cutoffs for the multithreaded ones) sorts correctly, including the variants selected by the settings (partitioning, gap sequences, heaps, threads and sorting network instruction sets);
+ *  - the generators produce values in the right order and range on sizes just above 2^31 and 2^32 (only windows of indices are generated, not the arrays), and their values keep their order when they're scaled down to int;
+ *  - the allocations that don't fit into memory exit with EXIT_OUT_OF_MEMORY.
+ * Exits with 0 if all of them passed and 1 otherwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "sorting_algorithms.h"
+#include "generators.h"
+#include "sorting_networks.h"
+
+#define TEST_SEED 20061
+#define GENERATOR_WINDOW 4096 //elements generated at each window of the large sizes
+
+static const size_t KERNEL_TEST_SIZES[] = {0, 1, 2, 3, 16, 33, 100, 1000, 2500};
+#define NUM_KERNEL_TEST_SIZES (sizeof(KERNEL_TEST_SIZES) / sizeof(KERNEL_TEST_SIZES[0]))
+#define PARALLEL_TEST_SIZE 100000 //also sorted by the multithreaded kernels, well above PARALLEL_QUICKSORT_CUTOFF
+
+/*
+ * Sorts arrays of every element type, case and test size (and PARALLEL_TEST_SIZE, if "parallel" is true) with the given algorithm (or all of them, if "algorithm_id" is NULL) and prints the ones that weren't sorted correctly. Returns the number of failures.
+ */
+static int check_kernels(const char *algorithm_id, const char *variant, bool parallel)
+{
+    int sorts = 0, failures = 0;
+    for(int a = 0; a < get_num_algorithms(); a++) {
+        if(algorithm_id != NULL && strcmp(get_algorithm_id(a), algorithm_id) != 0)
+            continue;
+
+        for(int type = 0; type < NUM_ELEMENT_TYPES; type++) {
+            if(!is_algorithm_available(type, a))
+                continue;
+            for(int c = 0; c < NUM_CASES; c++) {
+                for(size_t s = 0; s < NUM_KERNEL_TEST_SIZES + parallel; s++, sorts++) {
+                    size_t size = (s < NUM_KERNEL_TEST_SIZES) ? KERNEL_TEST_SIZES[s] : PARALLEL_TEST_SIZE;
+                    if(!verify_sorting_algorithm(type, a, c, size)) {
+                        printf("\tFAILED: %s (%s) on %s, %s, size %zu\n", get_algorithm_id(a), variant, get_element_type_id(type), get_case_id(c), size);
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%s %s (%s): %d sorts, %d failed\n", (failures == 0) ? "[ OK ]" : "[FAIL]", (algorithm_id != NULL) ? algorithm_id : "all algorithms", variant, sorts, failures);
+    return failures;
+}
+
+/*
+ * Runs the algorithms with the default settings and then the variants of the ones that have settings.
+ */
+static int check_all_kernels(void)
+{
+    char variant[64];
+    int failures = check_kernels(NULL, "default settings", false);
+
+    for(int p = 0; p < NUM_PARTITIONS; p++) {
+        set_quicksort_partition(p);
+        snprintf(variant, sizeof(variant), "%s partition", get_partition_id(p));
+        failures += check_kernels("quicksort", variant, false) + check_kernels("parallel_quicksort", variant, false) + check_kernels("quicksort_network", variant, false);
+    }
+    set_quicksort_partition(HOARE_PARTITION);
+
+    for(int g = 0; g < NUM_GAP_SEQUENCES; g++) {
+        set_shellsort_gaps(g);
+        for(int threads = 1; threads <= 4; threads += 3) {
+            set_shellsort_threads(threads);
+            snprintf(variant, sizeof(variant), "%s gaps, %d thread%s", get_gap_sequence_id(g), threads, (threads > 1) ? "s" : "");
+            failures += check_kernels("shellsort", variant, threads > 1);
+        }
+    }
+    set_shellsort_gaps(CIURA_GAPS);
+    set_shellsort_threads(1);
+
+    static const HeapVariant HEAPS[] = {{4, false, false}, {8, false, false}, {2, true, false}, {4, true, true}, {8, true, true}};
+    for(size_t h = 0; h < sizeof(HEAPS) / sizeof(HEAPS[0]); h++) {
+        set_heap_variant(HEAPS[h]);
+        snprintf(variant, sizeof(variant), "%d-ary heap%s%s", HEAPS[h].arity, HEAPS[h].bottom_up ? ", bottom-up" : "", HEAPS[h].prefetch ? ", prefetch" : "");
+        failures += check_kernels("heapsort", variant, false);
+    }
+    set_heap_variant((HeapVariant) {2, false, false});
+
+    for(int threads = 1; threads <= 4; threads += 3) {
+        set_parallel_quicksort_threads(threads);
+        snprintf(variant, sizeof(variant), "%d thread%s", threads, (threads > 1) ? "s" : "");
+        failures += check_kernels("parallel_quicksort", variant, true);
+    }
+    set_parallel_quicksort_threads(0);
+
+    for(int isa = NETWORK_ISA_SCALAR; isa < NUM_NETWORK_ISAS; isa++) {
+        if(!set_sorting_network_isa(isa)) {
+            printf("[SKIP] sorting networks (%s): not supported by this CPU\n", get_network_isa_id(isa));
+            continue;
+        }
+        snprintf(variant, sizeof(variant), "%s networks", get_network_isa_id(isa));
+        failures += check_kernels("quicksort_network", variant, false) + check_kernels("merge_sort_network", variant, false);
+    }
+    set_sorting_network_isa(NETWORK_ISA_AUTO);
+    return failures;
+}
+
+/*
+ * Writes the first indices of the windows of GENERATOR_WINDOW elements checked on an array of the given size: at the start, around the index 2^31, in the middle and at the end.
+ */
+static void window_firsts(size_t size, size_t firsts[4])
+{
+    size_t around_2_31 = ((size_t) 1 << 31) - GENERATOR_WINDOW / 2;
+    firsts[0] = 0;
+    firsts[1] = (around_2_31 < size - GENERATOR_WINDOW) ? around_2_31 : size - GENERATOR_WINDOW;
+    firsts[2] = size / 2;
+    firsts[3] = size - GENERATOR_WINDOW;
+}
+
+/*
+ * Maps windows of the indices of arrays of the given size (which is too big to be generated) to int with scaled_value, as the ordered generators do with their values (up to size - 1 or, for the almost sorted arrays, size - 1 + k), and checks that the ints start at 0, never decrease and reach the top of the int range (up to rounding).
+ */
+static int check_int_scaling(size_t size)
+{
+    size_t firsts[4];
+    window_firsts(size, firsts);
+    const size_t MAXES[] = {size - 1, size - 1 + 10};
+
+    int failures = 0;
+    for(size_t m = 0; m < sizeof(MAXES) / sizeof(MAXES[0]); m++) {
+        size_t max = MAXES[m];
+        bool ok = scaled_value(0, max) == 0 && scaled_value(max, max) >= INT_MAX - 1;
+        for(int w = 0; w < 4 && ok; w++) {
+            int prev = (firsts[w] > 0) ? scaled_value(firsts[w] - 1, max) : 0;
+            for(size_t i = firsts[w]; i < firsts[w] + GENERATOR_WINDOW && ok; i++) {
+                int v = scaled_value(i, max);
+                ok = v >= prev;
+                prev = v;
+            }
+        }
+        if(!ok) {
+            printf("\tFAILED: scaling of the values up to %zu to int\n", max);
+            failures++;
+        }
+    }
+
+    printf("%s int scaling (size %zu): %d failed\n", (failures == 0) ? "[ OK ]" : "[FAIL]", size, failures);
+    return failures;
+}
+
+/*
+ * Checks the element i of a window of an array of the given case and size, whose values are v (the previous element, if it's in the window, is "prev"). Returns false if it's out of the range of the case or out of order.
+ */
+static bool check_generated_value(int array_case, size_t size, size_t i, size_t v, const size_t *prev)
+{
+    if(v > get_case_max_value(array_case, size))
+        return false;
+
+    switch(array_case) {
+        case SORTED_CASE:
+        case RANDOM_SWAPS_CASE: //the swaps are made by fill_array, after the values are generated
+            return v == i;
+        case INVERSELY_SORTED_CASE:
+            return v == size - 1 - i;
+        case ALMOST_SORTED_CASE:
+            return v >= i && v <= i + get_almost_sorted_k();
+        case ORGAN_PIPE_CASE:
+            return v == ((i < size - 1 - i) ? i : size - 1 - i);
+        case SAWTOOTH_CASE: {
+            size_t period = (size + SAWTOOTH_TEETH - 1) / SAWTOOTH_TEETH;
+            return v == i % period && (prev == NULL || v == 0 || v == *prev + 1);
+        }
+        default: //random values: only the range is checked
+            return true;
+    }
+}
+
+/*
+ * Generates windows of GENERATOR_WINDOW elements (see window_firsts) of arrays of every case with the given size, which is too big to be generated, and checks their values.
+ * The windows are generated twice, the second time shifted by one element, to check that each value depends only on its index. Some values of the random case must also be in the upper half of [0, size - 1], which they wouldn't be if the size were truncated to 32 bits.
+ */
+static int check_generator_windows(size_t size)
+{
+    size_t firsts[4];
+    window_firsts(size, firsts);
+    size_t *values = malloc(GENERATOR_WINDOW * sizeof(size_t)), *shifted = malloc(GENERATOR_WINDOW * sizeof(size_t));
+    if(values == NULL || shifted == NULL) {
+        printf("[FAIL] generators (size %zu): not enough memory for the windows\n", size);
+        free(values);  free(shifted);
+        return 1;
+    }
+
+    int failures = 0;
+    for(int c = 0; c < NUM_CASES; c++) {
+        bool ok = true;
+        size_t max_value = 0;
+        for(int w = 0; w < 4; w++) {
+            size_t first = firsts[w];
+            generate_values(c, size, 0, first, GENERATOR_WINDOW, values);
+            generate_values(c, size, 0, first + 1, GENERATOR_WINDOW - 1, shifted);
+            for(size_t j = 0; j < GENERATOR_WINDOW && ok; j++) {
+                ok = check_generated_value(c, size, first + j, values[j], (j > 0) ? &values[j-1] : NULL) && (j == 0 || shifted[j-1] == values[j]);
+                max_value = (values[j] > max_value) ? values[j] : max_value;
+            }
+        }
+
+        if(!ok || (c == RANDOM_CASE && max_value < size / 2)) {
+            printf("\tFAILED: %s generator on size %zu%s\n", get_case_id(c), size, ok ? " (no value in the upper half of the range)" : "");
+            failures++;
+        }
+    }
+
+    printf("%s generators (size %zu): %d cases, %d failed\n", (failures == 0) ? "[ OK ]" : "[FAIL]", size, NUM_CASES, failures);
+    free(values);  free(shifted);
+    return failures;
+}
+
+/*
+ * Runs "allocate" in a child process (with its stderr closed) and checks that it exits with EXIT_OUT_OF_MEMORY.
+ */
+static int check_out_of_memory(const char *description, void (*allocate)(void))
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if(pid == 0) {
+        if(freopen("/dev/null", "w", stderr) == NULL)
+            fclose(stderr);
+        allocate();
+        _exit(0);
+    }
+
+    int status;
+    bool ok = pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_OUT_OF_MEMORY;
+    printf("%s out of memory: %s\n", ok ? "[ OK ]" : "[FAIL]", description);
+    return ok ? 0 : 1;
+}
+
+static void allocate_overflowing_count(void) {checked_malloc(SIZE_MAX / 2, 4);}
+static void allocate_too_much(void) {checked_malloc(SIZE_MAX / 16, 4);}
+static void analyze_too_big_array(void) {free_sorting_info(analyze_sorting_algorithm(INT_ELEMENTS, find_algorithm("quicksort"), RANDOM_CASE, SIZE_MAX / 16, 1, NULL));}
+
+int main(void)
+{
+    set_random_seed(TEST_SEED);
+    int failures = check_all_kernels();
+    for(int k = 31; k <= 32; k++) {
+        size_t size = ((size_t) 1 << k) + 3;
+        failures += check_generator_windows(size);
+        failures += check_int_scaling(size);
+    }
+    failures += check_out_of_memory("checked_malloc (count * size overflows)", &allocate_overflowing_count);
+    failures += check_out_of_memory("checked_malloc (bigger than the address space)", &allocate_too_much);
+    failures += check_out_of_memory("analyze_sorting_algorithm (array bigger than the memory)", &analyze_too_big_array);
+
+    printf("\n%s\n", (failures == 0) ? "All tests passed." : "SOME TESTS FAILED!");
+    return (failures == 0) ? 0 : 1;
+}